@@ -23,8 +23,8 @@ import DataTable from "./components/DataTable";
 import StatusPanel from "./components/StatusPanel";
 import StatusTiles from "./components/StatusTiles";
 
-// ESP32 tempo real (apenas para tiles/notificações)
-import { useEspTelemetry } from "./hooks/useEspTelemetry";
+// ESP32 tempo real via /stream (SSE, com fallback para polling) – apenas tiles/notificações
+import { useEspStream } from "./hooks/useEspStream";
 import { calibrate } from "./api/esp"; // Importar a função de calibração
 
 const MAX_POINTS_DB = 200;
@@ -34,7 +34,7 @@ export default function App() {
   const [deviceId, setDeviceId] = useState("esp32-01");
 
   // ===== 1) ESP32 tempo real — somente tiles/notificações
-  const { data: esp, error: espError } = useEspTelemetry();
+  const { data: esp, error: espError } = useEspStream();
   const SOIL_MAX = 4095;
 
   const soilPctLive = useMemo(() => {
@@ -4,18 +4,132 @@ export type EspData = {
   ldr_raw: number;  ldr_v?: number;  ldr_pct?: number;
   ldr_dark?: number; ldr_light?: number;
   temp_c?: number;   humid?: number;  dht_ok?: boolean;
+  water_raw?: number; water_v?: number; water_pct?: number;
+  water_empty?: number; water_full?: number;
+  pump_on?: boolean; pump_ms_sug?: number; rule_id?: number;
+  seq?: number;
 };
 
 const BASE = import.meta.env.VITE_ESP_BASE_URL;
 
-export async function getTelemetry(): Promise<EspData> {
-  const r = await fetch(`${BASE}/data`, { cache: "no-store" });
+// 503 BUSY = a task de controle ainda usava o slot do perfil e nada mudou
+// (troca/recarga de perfil); repete algumas vezes antes de desistir
+async function fetchRetryBusy(url: string, init?: RequestInit, tries = 3): Promise<Response> {
+  for (let i = 1; ; i++) {
+    const r = await fetch(url, init);
+    if (r.status !== 503 || i >= tries) return r;
+    await new Promise((ok) => setTimeout(ok, 250 * i));
+  }
+}
+
+// ===== /data binário v1 (telemetry_codec.h: struct empacotado, 30 bytes LE)
+const TELEMETRY_BIN_VERSION = 1;
+const TELEMETRY_BIN_SIZE = 30;
+const VOLTS_PER_COUNT = 3.3 / 4095;
+
+type Calibration = Pick<EspData,
+  "soil_dry" | "soil_wet" | "ldr_dark" | "ldr_light" | "water_empty" | "water_full">;
+
+export function decodeTelemetry(buf: ArrayBuffer): EspData & { cal_tag: number } {
+  if (buf.byteLength < TELEMETRY_BIN_SIZE) throw new Error("Telemetria binária truncada");
+  const v = new DataView(buf);
+  const ver = v.getUint8(0);
+  if (ver !== TELEMETRY_BIN_VERSION) throw new Error(`Versão de telemetria desconhecida (${ver})`);
+  const flags = v.getUint8(1);
+  const dhtOk = (flags & 1) !== 0;
+  const soilRaw = v.getUint16(20, true);
+  const ldrRaw = v.getUint16(22, true);
+  const waterRaw = v.getUint16(24, true);
+  return {
+    dht_ok: dhtOk,
+    pump_on: (flags & 2) !== 0,
+    soil_pct: v.getUint8(2),
+    ldr_pct: v.getUint8(3),
+    water_pct: v.getUint8(4),
+    rule_id: v.getUint8(5),
+    pump_ms_sug: v.getUint16(6, true),
+    seq: v.getUint32(8, true),
+    // 12..15: ts_ms (uptime do ESP32), não exposto
+    cal_tag: v.getUint32(16, true),
+    soil_raw: soilRaw, soil_v: soilRaw * VOLTS_PER_COUNT,
+    ldr_raw: ldrRaw,   ldr_v: ldrRaw * VOLTS_PER_COUNT,
+    water_raw: waterRaw, water_v: waterRaw * VOLTS_PER_COUNT,
+    temp_c: dhtOk ? v.getInt16(26, true) / 10 : NaN,
+    humid: dhtOk ? v.getUint16(28, true) / 10 : NaN,
+  };
+}
+
+// Calibração: recurso separado com ETag (por zona), só rebuscado quando o cal_tag muda
+const calCache = new Map<number, { etag: string; data: Calibration }>();
+
+async function getCalibration(tag: number, zone: number): Promise<Calibration> {
+  const etag = `"${tag.toString(16).padStart(8, "0")}"`;
+  const cached = calCache.get(zone);
+  if (cached?.etag === etag) return cached.data;
+  const headers: HeadersInit = cached ? { "If-None-Match": cached.etag } : {};
+  const r = await fetch(`${BASE}/cal?type=show&zone=${zone}`, { headers });
+  if (r.status === 304 && cached) return cached.data;
+  if (!r.ok) throw new Error(`Falha ao ler calibração (${r.status})`);
+  const fresh = { etag: r.headers.get("ETag") ?? etag, data: await r.json() };
+  calCache.set(zone, fresh);
+  return fresh.data;
+}
+
+export async function getTelemetry(zone = 0): Promise<EspData> {
+  const r = await fetch(`${BASE}/data?zone=${zone}`, { cache: "no-store", headers: { Accept: "application/octet-stream" } });
   if (!r.ok) throw new Error(`ESP32 offline (${r.status})`);
-  return r.json();
+  // firmware antigo ignora o Accept e responde JSON
+  if (!r.headers.get("Content-Type")?.includes("octet-stream")) return r.json();
+  const { cal_tag, ...data } = decodeTelemetry(await r.arrayBuffer());
+  return { ...data, ...(await getCalibration(cal_tag, zone)) };
+}
+
+// Server-Sent Events: frames "full" e "delta" (só campos alterados)
+export function telemetryStreamUrl(): string {
+  return `${BASE}/stream`;
 }
 
-export async function calibrate(type: "sd" | "sw" | "ld" | "ll" | "we" | "wf" | "save" | "load" | "reset" | "show") {
-  const r = await fetch(`${BASE}/cal?type=${type}`);
+export async function calibrate(type: "sd" | "sw" | "ld" | "ll" | "we" | "wf" | "save" | "load" | "reset" | "show", zone = 0) {
+  const r = await fetchRetryBusy(`${BASE}/cal?type=${type}&zone=${zone}`);
   if (!r.ok) throw new Error("Falha ao calibrar");
   return r.text();
 }
+
+// ===== Perfis de planta (/profile; gravados na NVS junto com a calibração)
+export type PlantProfile = {
+  name: string; active?: boolean;
+  water_min: number; soil_on: number; soil_off: number;
+  pump_max_ms: number; max_pumps: number; min_run_ms: number;
+  mf: Record<string, [number, number, number]>;   // conjunto -> a,b,c
+  rules_ms: number[];                              // singletons R1..R8
+};
+
+export async function listProfiles(): Promise<{ active: string; profiles: string[] }> {
+  const r = await fetch(`${BASE}/profile`, { cache: "no-store" });
+  if (!r.ok) throw new Error(`Falha ao listar perfis (${r.status})`);
+  return r.json();
+}
+
+export async function getProfile(name: string): Promise<PlantProfile> {
+  const r = await fetch(`${BASE}/profile?name=${encodeURIComponent(name)}`, { cache: "no-store" });
+  if (!r.ok) throw new Error(`Perfil não encontrado (${r.status})`);
+  return r.json();
+}
+
+export async function activateProfile(name: string) {
+  const r = await fetchRetryBusy(`${BASE}/profile?use=${encodeURIComponent(name)}`);
+  if (!r.ok) throw new Error(`Falha ao trocar perfil: ${await r.text()}`);
+}
+
+// Inclui/atualiza (campos omitidos ficam como estão); erro 400 traz o campo inválido
+export async function saveProfile(p: Partial<PlantProfile> & { name: string }, activate = false) {
+  const body = new URLSearchParams();
+  for (const [k, v] of Object.entries(p)) {
+    if (k === "active" || v === undefined) continue;
+    if (k === "mf") for (const [set, abc] of Object.entries(v as PlantProfile["mf"])) body.set(`mf_${set}`, abc.join(","));
+    else body.set(k, Array.isArray(v) ? v.join(",") : String(v));
+  }
+  if (activate) body.set("use", "1");
+  const r = await fetchRetryBusy(`${BASE}/profile`, { method: "POST", body });
+  if (!r.ok) throw new Error(`Perfil rejeitado: ${await r.text()}`);
+}
@@ -0,0 +1,83 @@
+import { useEffect, useRef, useState } from "react";
+import { getTelemetry, telemetryStreamUrl } from "../api/esp";
+
+const POLL = Number(import.meta.env.VITE_ESP_POLL_MS ?? 1000);
+const RETRY_STREAM_MS = 15000;
+
+// Telemetria via /stream (SSE) com fallback para polling em /data.
+// Mesmo retorno do useEspTelemetry, mais `mode` ("stream" | "poll").
+export function useEspStream() {
+  const [data, setData] = useState(null);
+  const [error, setError] = useState(null);
+  const [mode, setMode] = useState("stream");
+  const lastId = useRef(null);
+
+  useEffect(() => {
+    let es = null;
+    let pollTimer = null;
+    let retryTimer = null;
+    let closed = false;
+
+    const poll = async () => {
+      try { setData(await getTelemetry()); setError(null); }
+      catch (e) { setError(e?.message || "erro"); }
+    };
+
+    const startPolling = () => {
+      if (pollTimer === null) {
+        setMode("poll");
+        poll();
+        pollTimer = window.setInterval(poll, POLL);
+      }
+      if (retryTimer === null && !closed) {
+        retryTimer = window.setTimeout(() => { retryTimer = null; openStream(); }, RETRY_STREAM_MS);
+      }
+    };
+
+    const stopPolling = () => {
+      if (pollTimer !== null) window.clearInterval(pollTimer);
+      if (retryTimer !== null) window.clearTimeout(retryTimer);
+      pollTimer = retryTimer = null;
+    };
+
+    function openStream() {
+      if (closed || typeof EventSource === "undefined") { startPolling(); return; }
+      es = new EventSource(telemetryStreamUrl());
+
+      es.addEventListener("full", (ev) => {
+        lastId.current = Number(ev.lastEventId);
+        setData(JSON.parse(ev.data));
+        setError(null);
+        stopPolling();
+        setMode("stream");
+      });
+
+      es.addEventListener("delta", (ev) => {
+        const id = Number(ev.lastEventId);
+        const gap = lastId.current !== null && id !== lastId.current + 1;
+        lastId.current = id;
+        const patch = JSON.parse(ev.data);
+        setData((prev) => ({ ...(prev ?? {}), ...patch }));
+        // frame perdido: o delta não basta, ressincroniza pelo /data
+        if (gap) poll();
+      });
+
+      es.onerror = () => {
+        es?.close();
+        es = null;
+        lastId.current = null;
+        setError("stream indisponível");
+        startPolling();
+      };
+    }
+
+    openStream();
+    return () => {
+      closed = true;
+      es?.close();
+      stopPolling();
+    };
+  }, []);
+
+  return { data, error, mode };
+}
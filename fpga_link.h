@@ -0,0 +1,142 @@
+#pragma once
+/*
+ * Cliente do FPGA/rtl/uart_regs_simple.vhd (coprocessador fuzzy + guard).
+ *
+ * Protocolo (1 byte por registrador):
+ *   escrita: 0xA5 <addr> <valor>
+ *   leitura: 0x5A <addr> 0x00     -> o FPGA responde <valor>
+ * A FSM da RTL só responde a leitura no estado GOT_ADDR, isto é, ao receber
+ * um 3º byte; por isso cada leitura leva um byte de enchimento (0x00 em IDLE
+ * é ignorado, então o quadro continua válido se a RTL passar a responder
+ * logo após o endereço).
+ *
+ * Uma troca = um único quadro de 30 bytes: as 4 escritas das entradas, o
+ * kick do watchdog (CTRL bit1) e as 5 leituras de saída, enviado numa só
+ * chamada a write() (cabe no FIFO TX da UART). As 5 respostas ficam em voo
+ * juntas e são recolhidas por poll(), sem bloquear: o custo é ~1 ida e volta
+ * do quadro em vez de uma ida e volta por registrador.
+ *
+ * fault_code/status_reg seguem a concatenação do guard.vhd (bit3..bit0):
+ *   fault  = wd & water & sens & ovr
+ *   status = state_on & soil_low & wd_ok & water_ok
+ *
+ * Port precisa de (HardwareSerial já tem):
+ *   int available();  int read();  size_t write(const uint8_t*, size_t);
+ * No host (sim/) o Port é o modelo do FPGA (sim/fpga_model.h).
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+namespace fpga {
+  enum : uint8_t { CMD_WRITE = 0xA5, CMD_READ = 0x5A };
+  enum : uint8_t {
+    ADR_SOIL = 0x00, ADR_TEMP = 0x01, ADR_LIGHT = 0x02, ADR_WATER = 0x03, ADR_CTRL = 0x04,
+    ADR_PUMP = 0x10, ADR_MS_L = 0x11, ADR_MS_H  = 0x12, ADR_FAULT = 0x13, ADR_STAT = 0x14
+  };
+  enum : uint8_t { CTRL_WD_KICK = 0x02 };
+  enum : uint8_t { FAULT_OVR = 1, FAULT_SENS = 2, FAULT_WATER = 4, FAULT_WD = 8 };
+  enum : uint8_t { ST_WATER_OK = 1, ST_WD_OK = 2, ST_SOIL_LOW = 4, ST_ON = 8 };
+}
+
+struct FpgaInputs { uint8_t soilPct, tempC, luzPct, waterPct; };   // soil = umidade %
+struct FpgaResult { bool pumpOn; uint16_t pumpMs; uint8_t fault, status; };
+
+template <class Port>
+class FpgaLink {
+public:
+  static const uint8_t  NREADS     = 5;
+  static const uint8_t  FRAME_LEN  = 5 * 3 + NREADS * 3;   // 30 bytes
+  static const uint8_t  FAIL_LIMIT = 3;                    // timeouts seguidos até o backoff
+  static const uint32_t BACKOFF_US = 10000000;             // FPGA ausente: tenta a cada 10 s
+
+  enum State : uint8_t { IDLE, WAIT, DONE, TIMEOUT };
+
+  explicit FpgaLink(Port &port, uint32_t timeoutUs = 10000) : port_(port), timeoutUs_(timeoutUs) {}
+
+  // Descarta respostas atrasadas, envia o quadro inteiro e volta na hora.
+  // false = troca não iniciada (outra em voo, backoff ou TX cheio).
+  bool start(const FpgaInputs &in, uint32_t nowUs){
+    if (st_ == WAIT) return false;
+    if (failStreak_ >= FAIL_LIMIT && nowUs - t0_ < BACKOFF_US) return false;
+    while (port_.available() > 0){ port_.read(); stale_++; }
+
+    using namespace fpga;
+    const uint8_t f[FRAME_LEN] = {
+      CMD_WRITE, ADR_SOIL,  in.soilPct,
+      CMD_WRITE, ADR_TEMP,  in.tempC,
+      CMD_WRITE, ADR_LIGHT, in.luzPct,
+      CMD_WRITE, ADR_WATER, in.waterPct,
+      CMD_WRITE, ADR_CTRL,  CTRL_WD_KICK,
+      CMD_READ,  ADR_PUMP,  0,
+      CMD_READ,  ADR_MS_L,  0,
+      CMD_READ,  ADR_MS_H,  0,
+      CMD_READ,  ADR_FAULT, 0,
+      CMD_READ,  ADR_STAT,  0,
+    };
+    t0_ = nowUs;
+    got_ = 0;
+    exchanges_++;
+    if (port_.write(f, FRAME_LEN) != FRAME_LEN){ fail(); return false; }
+    st_ = WAIT;
+    return true;
+  }
+
+  // Recolhe o que chegou. true quando a troca terminou (DONE ou TIMEOUT).
+  bool poll(uint32_t nowUs){
+    if (st_ != WAIT) return true;
+    while (got_ < NREADS && port_.available() > 0) rx_[got_++] = (uint8_t)port_.read();
+    if (got_ == NREADS){
+      res_.pumpOn = rx_[0] & 1;
+      res_.pumpMs = (uint16_t)(rx_[1] | (rx_[2] << 8));
+      res_.fault  = rx_[3] & 0x0F;
+      res_.status = rx_[4] & 0x0F;
+      rttLastUs_ = nowUs - t0_;
+      if (rttLastUs_ > rttMaxUs_) rttMaxUs_ = rttLastUs_;
+      rttSumUs_ += rttLastUs_;
+      failStreak_ = 0;
+      st_ = DONE;
+      if (!ok()) faults_++;
+      return true;
+    }
+    if (nowUs - t0_ >= timeoutUs_){ fail(); return true; }
+    return false;
+  }
+
+  // Resultado utilizável: resposta completa, watchdog ok e sem falha de
+  // água/sensor. OVR só indica que o tempo foi saturado em PUMP_MAX_MS.
+  bool ok() const {
+    using namespace fpga;
+    return st_ == DONE && !(res_.fault & (FAULT_WD | FAULT_WATER | FAULT_SENS)) && (res_.status & ST_WD_OK);
+  }
+
+  // pump_ms utilizável como demanda: o guard.vhd zera pump_ms enquanto a
+  // histerese dele (30/40 %) está desligada, então sem ST_ON o 0 lido não é
+  // a saída do Sugeno e quem chama deve usar o cálculo local.
+  bool hasMs() const { return ok() && (res_.status & fpga::ST_ON); }
+
+  State             state()  const { return st_; }
+  const FpgaResult &result() const { return res_; }
+
+  uint32_t exchanges() const { return exchanges_; }
+  uint32_t timeouts()  const { return timeouts_; }
+  uint32_t faults()    const { return faults_; }
+  uint32_t stale()     const { return stale_; }
+  uint32_t rttLastUs() const { return rttLastUs_; }
+  uint32_t rttMaxUs()  const { return rttMaxUs_; }
+  uint32_t rttAvgUs()  const { uint32_t n = exchanges_ - timeouts_; return n ? (uint32_t)(rttSumUs_ / n) : 0; }
+
+private:
+  void fail(){ st_ = TIMEOUT; timeouts_++; failStreak_++; }
+
+  Port     &port_;
+  uint32_t  timeoutUs_;
+  State     st_ = IDLE;
+  uint32_t  t0_ = 0;
+  uint8_t   rx_[NREADS];
+  uint8_t   got_ = 0, failStreak_ = 0;
+  FpgaResult res_ = {};
+
+  uint32_t  exchanges_ = 0, timeouts_ = 0, faults_ = 0, stale_ = 0;
+  uint32_t  rttLastUs_ = 0, rttMaxUs_ = 0;
+  uint64_t  rttSumUs_ = 0;
+};
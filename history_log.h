@@ -0,0 +1,327 @@
+#pragma once
+/*
+ * Histórico local em anel (RNF-03 / RF-10).
+ *
+ * Anel pré-alocado com NSEG segmentos de 4 KB (um bloco de flash cada).
+ * Cada segmento = cabeçalho de 16 B + 170 registros de 24 B. Os registros
+ * ficam num buffer em RAM e são gravados em lote (FLUSH_RECS por
+ * vez ou ao fechar o segmento), com teto de gravações por hora para limitar
+ * o desgaste da flash. Quando o anel enche, o segmento mais antigo é reusado.
+ *
+ * Um registro só é válido se gen == (seq do segmento & 0xFF) e o CRC-8
+ * confere, então não é preciso apagar o segmento ao reusá-lo. No boot, só os
+ * cabeçalhos são lidos para montar o índice de tempo em RAM (seq + ts do
+ * primeiro registro por segmento); a consulta por intervalo pula direto para
+ * os segmentos que podem conter [from, to].
+ *
+ * Sem NTP o ts é o uptime e recomeça a cada boot. Um registro com ts menor
+ * que o anterior marca o segmento como HSEG_UNORDERED (no cabeçalho, que é
+ * regravado nessa hora); enquanto houver um segmento marcado no anel, a
+ * consulta percorre todos em vez de confiar na ordem do índice.
+ *
+ * Cada registro gravado tem um nº de sequência implícito, contínuo e que
+ * sobrevive ao reboot: (seq do segmento - 1) * SEG_RECS + posição (os
+ * segmentos enchem em ordem). É o cursor do envio à nuvem (upload_queue.h).
+ *
+ * Storage precisa de:
+ *   bool read (uint32_t off, void* buf, size_t n);
+ *   bool write(uint32_t off, const void* buf, size_t n);
+ * off é relativo a FILE_SIZE e nenhuma chamada atravessa um segmento. No
+ * ESP32 cada segmento é um arquivo do LittleFS; no host (sim/) é memória.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#pragma pack(push, 1)
+struct HistRecord {
+  uint32_t ts;           // epoch (s) – ou segundos desde o boot sem NTP
+  uint16_t soilRaw, ldrRaw, waterRaw;
+  int16_t  temp_dC;      // °C x10 (INT16_MIN = DHT inválido)
+  uint16_t humid_dPct;   // % x10
+  uint16_t pumpMsSug;
+  uint8_t  soilPct, ldrPct, waterPct;
+  uint8_t  flags;        // bit0 pump_on, bit1 dht_ok
+  uint8_t  ruleId;
+  uint8_t  gen;          // (seq do segmento) & 0xFF
+  uint8_t  crc;          // CRC-8 dos bytes anteriores
+  uint8_t  _rsv;
+};
+struct HistSegHeader {
+  uint32_t magic;
+  uint32_t seq;          // geração do segmento (0 = nunca usado)
+  uint32_t firstTs;
+  uint16_t recSize;
+  uint8_t  flags;        // HSEG_*
+  uint8_t  _rsv;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(HistRecord) == 24, "HistRecord deve ter 24 bytes");
+static_assert(sizeof(HistSegHeader) == 16, "HistSegHeader deve ter 16 bytes");
+
+enum : uint8_t { HIST_PUMP_ON = 1, HIST_DHT_OK = 2 };
+enum : uint8_t { HSEG_UNORDERED = 1 };   // ts voltou atrás dentro do segmento (reboot sem NTP)
+
+template <class Storage, uint16_t NSEG = 64>
+class HistoryLog {
+public:
+  static const uint32_t SEG_SIZE     = 4096;
+  static const uint32_t SEG_RECS     = (SEG_SIZE - sizeof(HistSegHeader)) / sizeof(HistRecord);
+  static const uint32_t FILE_SIZE    = SEG_SIZE * NSEG;
+  static const uint8_t  FLUSH_RECS   = 16;   // registros por gravação
+  static const uint8_t  BUF_RECS     = 32;   // folga em RAM se o orçamento estourar
+  static const uint8_t  MAX_FLUSH_H  = 8;    // gravações (blocos de 4 KB) por hora
+  static const uint32_t MAGIC        = 0x474F4C48; // "HLOG"
+
+  explicit HistoryLog(Storage &st) : st_(st) {}
+
+  // Lê os cabeçalhos e localiza o fim do log. Retorna nº de segmentos válidos.
+  int begin(){
+    int valid = 0;
+    head_ = 0; headSeq_ = 0; headCount_ = 0;
+    for (uint16_t s = 0; s < NSEG; s++){
+      HistSegHeader h;
+      idx_[s] = IndexEntry();
+      if (!st_.read(s * SEG_SIZE, &h, sizeof(h))) continue;
+      if (h.magic != MAGIC || h.recSize != sizeof(HistRecord) || h.seq == 0) continue;
+      idx_[s].seq = h.seq; idx_[s].firstTs = h.firstTs; idx_[s].flags = h.flags;
+      valid++;
+      if (h.seq > headSeq_){ headSeq_ = h.seq; head_ = s; }
+    }
+    if (headSeq_){
+      // conta os registros válidos do segmento corrente
+      HistRecord r;
+      while (headCount_ < SEG_RECS && readRec(head_, headCount_, r)){ lastTs_ = r.ts; headCount_++; }
+      if (!headCount_) lastTs_ = idx_[head_].firstTs;
+    }
+    return valid;
+  }
+
+  // Enfileira um registro (gen/crc são preenchidos aqui). nowSec = relógio do chamador.
+  void append(const HistRecord &rec, uint32_t nowSec){
+    if (bufN_ == BUF_RECS){ dropped_++; return; }
+    buf_[bufN_++] = rec;
+    if (bufN_ >= FLUSH_RECS || (headSeq_ && headCount_ + bufN_ >= SEG_RECS)) flush(nowSec);
+  }
+
+  // Grava o buffer respeitando o orçamento de gravações por hora.
+  bool flush(uint32_t nowSec, bool force = false){
+    if (!bufN_) return true;
+    if (nowSec - hourStart_ >= 3600){ hourStart_ = nowSec; flushesThisHour_ = 0; }
+    if (!force && flushesThisHour_ >= MAX_FLUSH_H) return false;
+
+    uint8_t done = 0;
+    while (done < bufN_){
+      if (!headSeq_ || headCount_ >= SEG_RECS) openSegment(buf_[done].ts);
+      uint32_t n = SEG_RECS - headCount_;
+      if (n > (uint32_t)(bufN_ - done)) n = bufN_ - done;
+      // cabeçalho + registros contíguos numa única gravação quando o segmento é novo
+      uint8_t tmp[sizeof(HistSegHeader) + FLUSH_RECS * sizeof(HistRecord)];
+      uint32_t off = recOffset(head_, headCount_), len = 0;
+      uint32_t chunk = n;
+      if (chunk > FLUSH_RECS) chunk = FLUSH_RECS;
+      uint8_t flags = idx_[head_].flags;
+      for (uint32_t i = 0; i < chunk; i++){
+        if (buf_[done + i].ts < lastTs_) flags |= HSEG_UNORDERED;
+        lastTs_ = buf_[done + i].ts;
+      }
+      bool newFlags = flags != idx_[head_].flags;
+      idx_[head_].flags = flags;
+      if (headCount_ == 0){
+        header(tmp); len = sizeof(HistSegHeader); off = head_ * SEG_SIZE;
+      } else if (newFlags){
+        // segmento já aberto: regrava o cabeçalho com a marca (raro: 1x por reboot sem NTP)
+        if (!st_.write(head_ * SEG_SIZE, header(tmp), sizeof(HistSegHeader))) return false;
+        bytesWritten_ += sizeof(HistSegHeader);
+      }
+      for (uint32_t i = 0; i < chunk; i++){
+        HistRecord r = buf_[done + i];
+        seal(r, headSeq_);
+        memcpy(tmp + len, &r, sizeof(r)); len += sizeof(r);
+      }
+      if (!st_.write(off, tmp, len)) return false;
+      bytesWritten_ += len;
+      headCount_ += chunk;
+      done += chunk;
+    }
+    bufN_ = 0;
+    flushesThisHour_++;
+    flushes_++;
+    return true;
+  }
+
+  // Consulta retomável (/history em partes): a posição é o nº de sequência
+  // do próximo registro a visitar (o buffer em RAM continua a numeração da
+  // flash, então um flush entre as partes não muda nada) e o estado do step
+  // vai junto. Se o anel der a volta no meio, segue do mais antigo que sobrou.
+  struct Cursor {
+    uint32_t from = 0, to = 0, step = 0;
+    uint32_t seq = 0, next = 0, last = 0, emitted = 0;
+    bool     done = false;
+  };
+  static Cursor cursor(uint32_t from, uint32_t to, uint32_t step){
+    Cursor c;
+    c.from = from; c.to = to; c.step = step; c.next = from;
+    return c;
+  }
+
+  // Percorre [from, to] em ordem, emitindo no máximo um registro a cada `step` s.
+  // fn(const HistRecord&) retorna false para interromper. Inclui o que está em RAM.
+  template <class Fn>
+  uint32_t query(uint32_t from, uint32_t to, uint32_t step, Fn fn){
+    Cursor c = cursor(from, to, step);
+    resume(c, fn);
+    return c.emitted;
+  }
+
+  // Continua c até o fim ou até fn retornar false (o registro entregue conta).
+  // true se ainda há o que visitar.
+  template <class Fn>
+  bool resume(Cursor &c, Fn fn){
+    if (c.done) return false;
+    bool stop = false;
+    auto visit = [&](const HistRecord &r){
+      if (r.ts < c.last) c.next = c.from;     // relógio recomeçou: o step vale de novo
+      c.last = r.ts;
+      if (r.ts < c.from || r.ts > c.to || r.ts < c.next) return;
+      c.emitted++;
+      uint32_t d = c.step ? c.step : 1;
+      c.next = r.ts > UINT32_MAX - d ? UINT32_MAX : r.ts + d;   // sem dar a volta
+      if (!fn(r)) stop = true;
+    };
+
+    uint16_t order[NSEG]; uint16_t n = sortedSegments(order);
+    bool ordered = true;
+    for (uint16_t i = 0; i < n; i++){
+      if (idx_[order[i]].flags & HSEG_UNORDERED) ordered = false;
+      if (i && idx_[order[i]].firstTs < idx_[order[i - 1]].firstTs) ordered = false;
+    }
+    for (uint16_t i = 0; i < n && !stop; i++){
+      uint16_t s = order[i];
+      uint32_t base = (idx_[s].seq - 1) * SEG_RECS;
+      uint32_t cnt = (s == head_) ? headCount_ : SEG_RECS;
+      if (base + cnt <= c.seq) continue;                   // já visitado
+      if (ordered){
+        if (idx_[s].firstTs > c.to){ c.done = true; return false; }
+        // segmento inteiro antes de `from`: o próximo já começa antes de from
+        if (i + 1 < n && idx_[order[i + 1]].firstTs < c.from) continue;
+      }
+      HistRecord batch[8];
+      for (uint32_t k = c.seq > base ? c.seq - base : 0; k < cnt && !stop; k += 8){
+        uint32_t m = cnt - k < 8 ? cnt - k : 8;
+        if (!st_.read(recOffset(s, k), batch, m * sizeof(HistRecord))) break;
+        for (uint32_t j = 0; j < m && !stop; j++){
+          c.seq = base + k + j + 1;
+          if (valid(batch[j], idx_[s].seq)) visit(batch[j]);
+        }
+      }
+    }
+    uint32_t base = endSeq();
+    for (uint8_t i = 0; i < bufN_ && !stop; i++){
+      if (base + i < c.seq) continue;
+      c.seq = base + i + 1;
+      visit(buf_[i]);
+    }
+    if (!stop) c.done = true;
+    return !c.done;
+  }
+
+  /* ---------- leitura por nº de sequência (só o que já está na flash) ---------- */
+  // [firstSeq(), endSeq()): o mais antigo ainda no anel e o próximo a gravar
+  uint32_t endSeq() const { return headSeq_ ? (headSeq_ - 1) * SEG_RECS + headCount_ : 0; }
+  uint32_t firstSeq() const {
+    uint16_t order[NSEG];
+    return sortedSegments(order) ? (idx_[order[0]].seq - 1) * SEG_RECS : 0;
+  }
+
+  // Até max posições a partir de seq, em ordem: fn(seq, const HistRecord&).
+  // Registros com CRC ruim são pulados (o nº não é reaproveitado).
+  // Retorna o nº seguinte ao último lido.
+  template <class Fn>
+  uint32_t readSeq(uint32_t seq, uint32_t max, Fn fn){
+    uint32_t end = endSeq();
+    if (seq < firstSeq()) seq = firstSeq();
+    while (seq < end && max){
+      uint32_t segSeq = seq / SEG_RECS + 1, i = seq % SEG_RECS;
+      uint16_t s = (uint16_t)((head_ + NSEG - (headSeq_ - segSeq) % NSEG) % NSEG);
+      if (idx_[s].seq != segSeq){ seq = segSeq * SEG_RECS; continue; }
+      uint32_t cnt = (s == head_) ? headCount_ : SEG_RECS;
+      HistRecord batch[8];
+      uint32_t m = cnt - i < 8 ? cnt - i : 8;
+      if (m > max) m = max;
+      if (!st_.read(recOffset(s, i), batch, m * sizeof(HistRecord))) break;
+      for (uint32_t j = 0; j < m; j++){
+        if (valid(batch[j], segSeq)) fn(seq, batch[j]);
+        seq++; max--;
+      }
+    }
+    return seq;
+  }
+
+  uint32_t dropped()      const { return dropped_; }
+  uint32_t flushes()      const { return flushes_; }
+  uint32_t bytesWritten() const { return bytesWritten_; }
+  uint8_t  pending()      const { return bufN_; }
+
+  static uint8_t crc8(const uint8_t *p, size_t n){
+    uint8_t c = 0xFF;
+    while (n--){
+      c ^= *p++;
+      for (int i = 0; i < 8; i++) c = (c & 0x80) ? (uint8_t)((c << 1) ^ 0x07) : (uint8_t)(c << 1);
+    }
+    return c;
+  }
+
+private:
+  struct IndexEntry { uint32_t seq = 0, firstTs = 0; uint8_t flags = 0; };
+
+  static uint32_t recOffset(uint16_t seg, uint32_t i){
+    return seg * SEG_SIZE + sizeof(HistSegHeader) + i * sizeof(HistRecord);
+  }
+  static void seal(HistRecord &r, uint32_t seq){
+    r.gen = (uint8_t)seq; r._rsv = 0;
+    r.crc = crc8((const uint8_t*)&r, offsetof(HistRecord, crc));
+  }
+  static bool valid(const HistRecord &r, uint32_t seq){
+    return r.gen == (uint8_t)seq && r.crc == crc8((const uint8_t*)&r, offsetof(HistRecord, crc));
+  }
+  bool readRec(uint16_t seg, uint32_t i, HistRecord &r){
+    return st_.read(recOffset(seg, i), &r, sizeof(r)) && valid(r, idx_[seg].seq);
+  }
+
+  void openSegment(uint32_t firstTs){
+    head_ = headSeq_ ? (uint16_t)((head_ + 1) % NSEG) : head_;
+    headSeq_++;
+    headCount_ = 0;
+    idx_[head_].seq = headSeq_; idx_[head_].firstTs = firstTs; idx_[head_].flags = 0;
+  }
+  const uint8_t *header(uint8_t *out) const {
+    HistSegHeader h = { MAGIC, headSeq_, idx_[head_].firstTs, (uint16_t)sizeof(HistRecord), idx_[head_].flags, 0 };
+    memcpy(out, &h, sizeof(h));
+    return out;
+  }
+
+  // segmentos válidos do mais antigo ao mais novo (ordem do anel a partir do head)
+  uint16_t sortedSegments(uint16_t *out) const {
+    uint16_t n = 0;
+    for (uint16_t k = 1; k <= NSEG; k++){
+      uint16_t s = (uint16_t)((head_ + k) % NSEG);
+      if (idx_[s].seq) out[n++] = s;
+    }
+    return n;
+  }
+
+  Storage   &st_;
+  IndexEntry idx_[NSEG];
+  uint16_t   head_ = 0;
+  uint32_t   headSeq_ = 0, headCount_ = 0;
+  uint32_t   lastTs_ = 0;                 // ts do último registro gravado
+
+  HistRecord buf_[BUF_RECS];
+  uint8_t    bufN_ = 0;
+
+  uint32_t   hourStart_ = 0;
+  uint8_t    flushesThisHour_ = 0;
+  uint32_t   dropped_ = 0, flushes_ = 0, bytesWritten_ = 0;
+};
@@ -0,0 +1,496 @@
+#pragma once
+/*
+ * Servidor HTTP/1.1 não bloqueante para o loop() (no lugar do WebServer
+ * síncrono do core, que atende um cliente por vez e espera cada um).
+ *
+ *   - até MAX_CONN conexões ao mesmo tempo em slots fixos (sem alocação).
+ *     Cada poll() aceita as conexões pendentes, lê o que já chegou em cada
+ *     uma e, com a requisição completa (cabeçalhos + corpo pelo
+ *     Content-Length), chama o handler da rota. Cliente lento só ocupa o
+ *     próprio slot;
+ *   - keep-alive (padrão do HTTP/1.1) com no máximo KEEPALIVE_MAX
+ *     requisições por conexão (rodízio dos slots quando há mais clientes que
+ *     slots) e IDLE_MS de ociosidade. Requisições em pipeline ficam no
+ *     buffer e são atendidas em seguida;
+ *   - a resposta é montada no buffer da conexão (corpo imutável, como a
+ *     página gzip em flash, vai por ponteiro) e escrita conforme o socket
+ *     aceita, nas próximas voltas do poll();
+ *   - API dos handlers no estilo do WebServer (arg/hasArg/header/
+ *     sendHeader/send), mas sem String: tudo aponta para o buffer da
+ *     requisição e vale só dentro do handler.
+ *
+ * Respostas longas (CSV do /history) saem em chunked por um gerador
+ * (sendChunked): a conexão guarda o estado dele (ex.: o cursor da consulta) e
+ * o poll() pede a próxima parte só quando a anterior saiu inteira. Cliente
+ * que para de ler só segura o próprio slot até IDLE_MS.
+ *
+ * beginChunked/sendChunk (/metrics, alguns KB) e send() com corpo maior que
+ * OUT_CAP ainda escrevem direto no socket, esperando; se ficarem WRITE_SPINS
+ * esperas sem progresso, a conexão é fechada e o resto da resposta descartado.
+ *
+ * Transporte por template, como o FpgaLink: Net::Client precisa de
+ * operator bool, connected(), available(), read(uint8_t*, size_t),
+ * write(const uint8_t*, size_t) (pode escrever menos que o pedido) e stop();
+ * Net precisa de Client accept() (inválido se não há conexão pendente) e
+ * wait() (cede a CPU nas escritas bloqueantes). No ESP32 é o WiFiServer; no
+ * host, sockets POSIX (sim/bench_http.cpp) ou memória (sim/test_http.cpp).
+ * Sem dependências do Arduino.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <utility>
+
+namespace http {
+
+enum Method : uint8_t { GET = 1, POST = 2, OPTIONS = 4, ANY = 0xFF };
+
+// Corpo formatado uma vez por versão dos dados (ex.: seq do snapshot +
+// calTag) e reenviado enquanto ela não muda. send() copia o corpo para a
+// conexão, então reescrever o cache não afeta respostas ainda em envio.
+template <size_t CAP>
+struct CachedBody {
+  uint32_t key = 0, ver = 0, tag = 0;
+  size_t   len = 0;
+  char     buf[CAP];
+
+  bool fresh(uint32_t k, uint32_t v, uint32_t t) const { return len && key == k && ver == v && tag == t; }
+  void store(uint32_t k, uint32_t v, uint32_t t, size_t n){ key = k; ver = v; tag = t; len = n; }
+};
+
+template <class Net, uint8_t MAX_CONN = 8>
+class Server {
+public:
+  typedef typename Net::Client Client;
+  typedef void (*Handler)();
+  // Gera a próxima parte do corpo em buf (até cap bytes) e retorna quantos;
+  // 0 encerra a resposta. Chamado do poll(), fora do handler.
+  typedef size_t (*Producer)(void *state, char *buf, size_t cap);
+
+  static const size_t   IN_CAP = 1024, OUT_CAP = 1024, HDR_CAP = 384;
+  static const size_t   STATE_CAP = 48;         // estado do gerador por conexão
+  static const uint8_t  CHUNKS_PER_POLL = 4;
+  static const uint8_t  MAX_ROUTES = 24, MAX_ARGS = 24, MAX_HEADERS = 16;
+  static const uint16_t KEEPALIVE_MAX = 16;
+  static const uint32_t IDLE_MS = 5000;
+  static const uint16_t WRITE_SPINS = 500;      // esperas sem progresso antes de desistir do cliente
+
+  bool keepAlive = true;    // false: fecha após cada resposta (HTTP/1.0)
+
+  explicit Server(Net &net) : net_(net) {}
+
+  void on(const char *path, uint8_t methods, Handler fn){
+    if (nRoutes_ < MAX_ROUTES) routes_[nRoutes_++] = { path, methods, fn };
+  }
+  void onNotFound(Handler fn){ notFound_ = fn; }
+
+  // Uma volta: aceita, lê, atende no máximo uma requisição por conexão e
+  // escreve o que couber. Nunca espera pela rede. true se algo andou.
+  bool poll(uint32_t nowMs){
+    now_ = nowMs;
+    bool busy = false;
+    for (uint8_t i = 0; i < MAX_CONN; i++){
+      if (conn_[i].st != FREE) continue;
+      Client c = net_.accept();
+      if (!c) break;
+      Conn &k = conn_[i];
+      k.c = std::move(c);
+      k.st = READ; k.inLen = 0; k.reqs = 0; k.lastMs = nowMs; k.close = false; k.gen = nullptr;
+      accepted_++;
+      busy = true;
+    }
+    for (uint8_t i = 0; i < MAX_CONN; i++) busy |= service(conn_[i]);
+    return busy;
+  }
+
+  /* ---------- requisição corrente (só dentro do handler) ---------- */
+  Method      method() const { return (Method)method_; }
+  const char *uri() const { return path_; }
+  const char *body() const { return body_; }
+  size_t      bodyLen() const { return bodyLen_; }
+
+  bool hasArg(const char *k) const { return findArg(k) >= 0; }
+  const char *arg(const char *k) const { int i = findArg(k); return i >= 0 ? args_[i].v : ""; }
+  const char *header(const char *name) const {
+    for (uint8_t i = 0; i < nHdrs_; i++) if (!strcasecmp(hdrs_[i].k, name)) return hdrs_[i].v;
+    return "";
+  }
+  bool acceptsGzip() const { return strstr(header("Accept-Encoding"), "gzip") != nullptr; }
+  bool connected() { return cur_ && cur_->c.connected(); }
+
+  /* ---------- resposta ---------- */
+  void sendHeader(const char *name, const char *value){
+    int k = snprintf(hdr_ + hdrLen_, HDR_CAP - hdrLen_, "%s: %s\r\n", name, value);
+    if (k > 0 && hdrLen_ + k < HDR_CAP) hdrLen_ += k;
+  }
+
+  // Corpo copiado para a conexão (pode ser buffer local do handler)
+  void send(int code, const char *type = nullptr, const char *body = nullptr, size_t n = (size_t)-1){
+    if (!body) body = "";
+    if (n == (size_t)-1) n = strlen(body);
+    respond(code, type, body, n, false);
+  }
+  // Corpo imutável enquanto o programa roda (PROGMEM/const): vai por ponteiro
+  void sendStatic(int code, const char *type, const void *body, size_t n){
+    respond(code, type, body, n, true);
+  }
+
+  // Corpo em chunked produzido aos pedaços por gen; state (n <= STATE_CAP
+  // bytes) é copiado para a conexão e passado a cada chamada
+  void sendChunked(int code, const char *type, Producer gen, const void *state, size_t n){
+    if (!cur_ || sent_) return;
+    if (n > STATE_CAP){ send(500, "text/plain", "STATE_TOO_LARGE"); return; }
+    Conn &k = *cur_;
+    sent_ = true;
+    k.outLen = head(k.out, OUT_CAP, code, type, 0, true);
+    k.outOff = 0; k.ext = nullptr; k.extLen = k.extOff = 0;
+    k.gen = gen;
+    memcpy(k.state, state, n);
+    k.st = WRITE;
+    flush(k);
+  }
+
+  // Resposta de tamanho desconhecido: escrita direto no socket, esperando
+  void beginChunked(int code, const char *type){
+    if (!cur_) return;
+    cur_->outLen = head(cur_->out, OUT_CAP, code, type, 0, true);
+    writeAll(*cur_, cur_->out, cur_->outLen);
+    cur_->outLen = 0;
+    sent_ = true;
+  }
+  void sendChunk(const char *b, size_t n){
+    if (!cur_ || !n) return;
+    char pre[12];
+    int k = snprintf(pre, sizeof(pre), "%x\r\n", (unsigned)n);
+    writeAll(*cur_, (const uint8_t*)pre, k);
+    writeAll(*cur_, (const uint8_t*)b, n);
+    writeAll(*cur_, (const uint8_t*)"\r\n", 2);
+  }
+  void endChunked(){ if (cur_) writeAll(*cur_, (const uint8_t*)"0\r\n\r\n", 5); }
+
+  // Entrega o socket ao handler (ex.: SSE); a conexão sai do servidor
+  Client detach(){
+    if (!cur_) return Client();
+    detached_ = true;
+    sent_ = true;
+    return std::move(cur_->c);
+  }
+
+  /* ---------- estatísticas ---------- */
+  uint32_t requests() const { return requests_; }
+  uint32_t accepted() const { return accepted_; }
+  uint8_t  active() const {
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < MAX_CONN; i++) n += conn_[i].st != FREE;
+    return n;
+  }
+
+private:
+  enum State : uint8_t { FREE, READ, WRITE };
+
+  struct Conn {
+    Client         c;
+    State          st = FREE;
+    bool           close = false;
+    uint16_t       reqs = 0;
+    uint32_t       lastMs = 0;
+    size_t         inLen = 0, outLen = 0, outOff = 0;
+    const uint8_t *ext = nullptr;         // corpo por ponteiro (sendStatic)
+    size_t         extLen = 0, extOff = 0;
+    Producer       gen = nullptr;         // corpo gerado aos pedaços (sendChunked)
+    alignas(8) uint8_t state[STATE_CAP];
+    uint8_t        in[IN_CAP];
+    uint8_t        out[OUT_CAP];
+  };
+  struct Route { const char *path; uint8_t methods; Handler fn; };
+  struct KV    { const char *k, *v; };
+
+  void drop(Conn &k){
+    k.c.stop();
+    k.c = Client();
+    k.st = FREE;
+    k.gen = nullptr;
+  }
+
+  bool service(Conn &k){
+    if (k.st == FREE) return false;
+    bool busy = false;
+    if (k.st == WRITE){
+      bool moved = flush(k);
+      for (uint8_t i = 0; i < CHUNKS_PER_POLL && k.gen && k.outOff == k.outLen; i++){
+        produce(k);
+        moved |= flush(k);
+      }
+      if (moved){ k.lastMs = now_; busy = true; }
+      if (k.gen || k.outOff < k.outLen || k.extOff < k.extLen){
+        if (now_ - k.lastMs > IDLE_MS || !k.c.connected()) drop(k);
+        return busy;
+      }
+      if (k.close){ drop(k); return true; }
+      k.st = READ;
+    }
+
+    int av = k.c.available();
+    if (av > 0 && k.inLen < IN_CAP - 1){
+      int r = k.c.read(k.in + k.inLen, IN_CAP - 1 - k.inLen);
+      if (r > 0){ k.inLen += r; k.lastMs = now_; busy = true; }
+    }
+    if (request(k)) return true;
+    if (k.st == READ && (now_ - k.lastMs > IDLE_MS || (av <= 0 && !k.c.connected()))) drop(k);
+    return busy;
+  }
+
+  // Atende a próxima requisição do buffer, se já está completa. Nada é
+  // alterado no buffer antes disso (a leitura seguinte reavalia do zero).
+  bool request(Conn &k){
+    if (k.st != READ || !k.inLen) return false;
+    char *buf = (char*)k.in;
+    buf[k.inLen] = 0;
+    char *end = strstr(buf, "\r\n\r\n");
+    if (!end){
+      if (k.inLen >= IN_CAP - 1){ error(k, 431, "HEADERS_TOO_LARGE"); return true; }
+      return false;
+    }
+    size_t hdrLen = end + 4 - buf, clen;
+    if (!contentLength(buf, end, clen)){ error(k, 400, "BAD_CONTENT_LENGTH"); return true; }
+    if (clen > IN_CAP - 1 - hdrLen){ error(k, 413, "TOO_LARGE"); return true; }
+    if (k.inLen < hdrLen + clen) return false;              // corpo ainda chegando
+
+    // corpo terminado em NUL sem perder o 1º byte da próxima requisição (pipeline)
+    size_t reqLen = hdrLen + clen;
+    uint8_t saved = k.in[reqLen];
+    k.in[reqLen] = 0;
+
+    // linha de requisição: MÉTODO caminho[?query] HTTP/1.x
+    char *eol = strstr(buf, "\r\n");
+    *eol = 0;
+    char *sp1 = strchr(buf, ' '), *sp2 = sp1 ? strchr(sp1 + 1, ' ') : nullptr;
+    if (!sp1 || !sp2){ error(k, 400, "BAD_REQUEST"); return true; }
+    *sp1 = 0; *sp2 = 0;
+    method_ = !strcmp(buf, "GET") ? GET : !strcmp(buf, "POST") ? POST : !strcmp(buf, "OPTIONS") ? OPTIONS : 0;
+    bool http11 = !strcmp(sp2 + 1, "HTTP/1.1");
+    path_ = sp1 + 1;
+
+    nHdrs_ = 0;
+    for (char *line = eol + 2; line < end; ){
+      char *nl = strstr(line, "\r\n");
+      *nl = 0;
+      char *colon = strchr(line, ':');
+      if (colon && nHdrs_ < MAX_HEADERS){
+        *colon = 0;
+        char *v = colon + 1;
+        while (*v == ' ') v++;
+        hdrs_[nHdrs_++] = { line, v };
+      }
+      line = nl + 2;
+    }
+    body_ = buf + hdrLen;  bodyLen_ = clen;
+
+    nArgs_ = 0;
+    char *q = strchr(sp1 + 1, '?');
+    if (q){ *q = 0; parseArgs(q + 1); }
+    if (method_ == POST && strstr(header("Content-Type"), "application/x-www-form-urlencoded")) parseArgs(body_);
+
+    const char *conn = header("Connection");
+    k.reqs++;
+    k.close = !keepAlive || k.reqs >= KEEPALIVE_MAX ||
+              (http11 ? !strcasecmp(conn, "close") : strcasecmp(conn, "keep-alive") != 0);
+
+    dispatch(k);
+
+    if (detached_){                                          // detach(): slot liberado sem fechar
+      k.c = Client(); k.st = FREE; detached_ = false;
+      return true;
+    }
+    k.in[reqLen] = saved;
+    memmove(k.in, k.in + reqLen, k.inLen - reqLen);
+    k.inLen -= reqLen;
+    return true;
+  }
+
+  // false se o valor não é um número decimal; acima de IN_CAP satura em
+  // IN_CAP (vira 413 sem estourar a conta de tamanho)
+  static bool contentLength(const char *buf, const char *end, size_t &len){
+    len = 0;
+    for (const char *p = strstr(buf, "\r\n"); p && p < end; p = strstr(p + 2, "\r\n")){
+      if (strncasecmp(p + 2, "Content-Length:", 15)) continue;
+      const char *v = p + 17;
+      while (*v == ' ' || *v == '\t') v++;
+      if (*v < '0' || *v > '9') return false;
+      for (; *v >= '0' && *v <= '9'; v++) if (len < IN_CAP) len = len * 10 + (*v - '0');
+      while (*v == ' ' || *v == '\t') v++;
+      if (len > IN_CAP) len = IN_CAP;
+      return *v == '\r';
+    }
+    return true;
+  }
+
+  void dispatch(Conn &k){
+    cur_ = &k; sent_ = false; hdrLen_ = 0;
+    Handler fn = nullptr;
+    bool pathFound = false;
+    for (uint8_t i = 0; i < nRoutes_ && !fn; i++){
+      if (strcmp(routes_[i].path, path_)) continue;
+      pathFound = true;
+      if (routes_[i].methods & method_) fn = routes_[i].fn;
+    }
+    requests_++;
+    if (!fn && !pathFound) fn = notFound_;
+    if (fn) fn();
+    else send(pathFound ? 405 : 404, "text/plain", pathFound ? "METHOD_NOT_ALLOWED" : "NOT_FOUND");
+    if (!sent_) send(500, "text/plain", "NO_RESPONSE");
+    cur_ = nullptr;
+  }
+
+  void respond(int code, const char *type, const void *body, size_t n, bool byRef){
+    if (!cur_ || sent_) return;
+    Conn &k = *cur_;
+    sent_ = true;
+    k.outLen = head(k.out, OUT_CAP, code, type, n, false);
+    k.outOff = 0; k.ext = nullptr; k.extLen = k.extOff = 0;
+    if (!byRef && k.outLen + n <= OUT_CAP){
+      memcpy(k.out + k.outLen, body, n);
+      k.outLen += n;
+    } else if (byRef){
+      k.ext = (const uint8_t*)body; k.extLen = n;
+    } else {                                                 // maior que o buffer: envia já, esperando
+      writeAll(k, k.out, k.outLen);
+      writeAll(k, (const uint8_t*)body, n);
+      k.outLen = 0;
+    }
+    k.st = WRITE;
+    flush(k);
+  }
+
+  size_t head(uint8_t *out, size_t cap, int code, const char *type, size_t n, bool chunked){
+    Conn &k = *cur_;
+    int len = snprintf((char*)out, cap, "HTTP/1.1 %d %s\r\n", code, reason(code));
+    if (type && *type) len += snprintf((char*)out + len, cap - len, "Content-Type: %s\r\n", type);
+    if (chunked) len += snprintf((char*)out + len, cap - len, "Transfer-Encoding: chunked\r\n");
+    else         len += snprintf((char*)out + len, cap - len, "Content-Length: %u\r\n", (unsigned)n);
+    len += snprintf((char*)out + len, cap - len, "Connection: %s\r\n%.*s\r\n",
+                    k.close ? "close" : "keep-alive", (int)hdrLen_, hdr_);
+    return (size_t)len < cap ? (size_t)len : cap;
+  }
+
+  void error(Conn &k, int code, const char *msg){
+    k.close = true;
+    cur_ = &k; sent_ = false; hdrLen_ = 0;
+    send(code, "text/plain", msg);
+    cur_ = nullptr;
+    k.inLen = 0;
+  }
+
+  // Escreve o que o socket aceitar agora. true se algo saiu.
+  bool flush(Conn &k){
+    bool moved = false;
+    while (k.outOff < k.outLen){
+      size_t w = k.c.write(k.out + k.outOff, k.outLen - k.outOff);
+      if (!w) return moved;
+      k.outOff += w; moved = true;
+    }
+    while (k.extOff < k.extLen){
+      size_t w = k.c.write(k.ext + k.extOff, k.extLen - k.extOff);
+      if (!w) return moved;
+      k.extOff += w; moved = true;
+    }
+    return moved;
+  }
+
+  // Próxima parte do sendChunked no buffer da conexão: o tamanho em hex vai
+  // logo antes dos dados (outOff começa nele); parte vazia = terminador
+  void produce(Conn &k){
+    const size_t PRE = 8;
+    size_t n = k.gen(k.state, (char*)k.out + PRE, OUT_CAP - PRE - 2);
+    if (n > OUT_CAP - PRE - 2) n = OUT_CAP - PRE - 2;
+    if (!n){
+      memcpy(k.out, "0\r\n\r\n", 5);
+      k.outOff = 0; k.outLen = 5; k.gen = nullptr;
+      return;
+    }
+    char pre[PRE + 1];
+    int p = snprintf(pre, sizeof(pre), "%x\r\n", (unsigned)n);
+    k.outOff = PRE - p;
+    memcpy(k.out + k.outOff, pre, p);
+    memcpy(k.out + PRE + n, "\r\n", 2);
+    k.outLen = PRE + n + 2;
+  }
+
+  // Cliente que não lê nada por WRITE_SPINS esperas é abandonado: fecha já,
+  // e as escritas seguintes da mesma resposta retornam sem esperar
+  void writeAll(Conn &k, const uint8_t *p, size_t n){
+    uint16_t spins = 0;
+    while (n && k.c.connected()){
+      size_t w = k.c.write(p, n);
+      if (w){ p += w; n -= w; spins = 0; continue; }
+      if (++spins > WRITE_SPINS){ k.c.stop(); k.close = true; return; }
+      net_.wait();
+    }
+  }
+
+  // k=v&k2=v2, decodificado no lugar (%XX e '+')
+  void parseArgs(char *s){
+    while (*s && nArgs_ < MAX_ARGS){
+      char *amp = strchr(s, '&');
+      if (amp) *amp = 0;
+      char *eq = strchr(s, '=');
+      if (eq) *eq = 0;
+      args_[nArgs_++] = { decode(s), eq ? decode(eq + 1) : "" };
+      if (!amp) break;
+      s = amp + 1;
+    }
+  }
+  static char *decode(char *s){
+    char *w = s;
+    for (char *r = s; *r; r++){
+      if (*r == '+') *w++ = ' ';
+      else if (*r == '%' && isHex(r[1]) && isHex(r[2])){ *w++ = (char)(hex(r[1]) << 4 | hex(r[2])); r += 2; }
+      else *w++ = *r;
+    }
+    *w = 0;
+    return s;
+  }
+  static bool isHex(char c){ return (c >= '0' && c <= '9') || ((c | 32) >= 'a' && (c | 32) <= 'f'); }
+  static int  hex(char c){ return c <= '9' ? c - '0' : (c | 32) - 'a' + 10; }
+
+  int findArg(const char *k) const {
+    for (uint8_t i = 0; i < nArgs_; i++) if (!strcmp(args_[i].k, k)) return i;
+    return -1;
+  }
+
+  static const char *reason(int code){
+    switch (code){
+      case 200: return "OK";           case 204: return "No Content";
+      case 304: return "Not Modified"; case 400: return "Bad Request";
+      case 404: return "Not Found";    case 405: return "Method Not Allowed";
+      case 409: return "Conflict";     case 413: return "Payload Too Large";
+      case 431: return "Request Header Fields Too Large";
+      case 503: return "Service Unavailable";
+      default:  return code < 400 ? "OK" : "Error";
+    }
+  }
+
+  Net     &net_;
+  Conn     conn_[MAX_CONN];
+  Route    routes_[MAX_ROUTES];
+  uint8_t  nRoutes_ = 0;
+  Handler  notFound_ = nullptr;
+  uint32_t now_ = 0, requests_ = 0, accepted_ = 0;
+
+  // requisição em atendimento
+  Conn       *cur_ = nullptr;
+  uint8_t     method_ = 0;
+  const char *path_ = "";
+  char       *body_ = nullptr;
+  size_t      bodyLen_ = 0;
+  KV          args_[MAX_ARGS], hdrs_[MAX_HEADERS];
+  uint8_t     nArgs_ = 0, nHdrs_ = 0;
+  char        hdr_[HDR_CAP];
+  size_t      hdrLen_ = 0;
+  bool        sent_ = false, detached_ = false;
+};
+
+}  // namespace http
@@ -0,0 +1,84 @@
+#pragma once
+// Gerado por "make -C sim web" a partir de web/index.html: não editar.
+#include <stdint.h>
+#include <stddef.h>
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+const uint8_t INDEX_HTML[] PROGMEM = {
+  0x3c, 0x21, 0x64, 0x6f, 0x63, 0x74, 0x79, 0x70, 0x65, 0x20, 0x68, 0x74,
+  0x6d, 0x6c, 0x3e, 0x3c, 0x6d, 0x65, 0x74, 0x61, 0x20, 0x63, 0x68, 0x61,
+  0x72, 0x73, 0x65, 0x74, 0x3d, 0x22, 0x75, 0x74, 0x66, 0x2d, 0x38, 0x22,
+  0x2f, 0x3e, 0x3c, 0x74, 0x69, 0x74, 0x6c, 0x65, 0x3e, 0x45, 0x53, 0x50,
+  0x33, 0x32, 0x3c, 0x2f, 0x74, 0x69, 0x74, 0x6c, 0x65, 0x3e, 0x0a, 0x3c,
+  0x70, 0x3e, 0x45, 0x6e, 0x64, 0x70, 0x6f, 0x69, 0x6e, 0x74, 0x73, 0x3a,
+  0x3c, 0x2f, 0x70, 0x3e, 0x0a, 0x3c, 0x75, 0x6c, 0x3e, 0x0a, 0x20, 0x20,
+  0x3c, 0x6c, 0x69, 0x3e, 0x2f, 0x64, 0x61, 0x74, 0x61, 0x3f, 0x7a, 0x6f,
+  0x6e, 0x65, 0x3d, 0x30, 0x20, 0x20, 0x28, 0x41, 0x63, 0x63, 0x65, 0x70,
+  0x74, 0x3a, 0x20, 0x61, 0x70, 0x70, 0x6c, 0x69, 0x63, 0x61, 0x74, 0x69,
+  0x6f, 0x6e, 0x2f, 0x6f, 0x63, 0x74, 0x65, 0x74, 0x2d, 0x73, 0x74, 0x72,
+  0x65, 0x61, 0x6d, 0x20, 0x7c, 0x20, 0x3f, 0x66, 0x6d, 0x74, 0x3d, 0x62,
+  0x69, 0x6e, 0x20, 0x2d, 0x3e, 0x20, 0x62, 0x69, 0x6e, 0xc3, 0xa1, 0x72,
+  0x69, 0x6f, 0x20, 0x76, 0x31, 0x29, 0x3c, 0x2f, 0x6c, 0x69, 0x3e, 0x0a,
+  0x20, 0x20, 0x3c, 0x6c, 0x69, 0x3e, 0x2f, 0x63, 0x61, 0x6c, 0x3f, 0x74,
+  0x79, 0x70, 0x65, 0x3d, 0x73, 0x64, 0x7c, 0x73, 0x77, 0x7c, 0x6c, 0x64,
+  0x7c, 0x6c, 0x6c, 0x7c, 0x77, 0x65, 0x7c, 0x77, 0x66, 0x5b, 0x26, 0x7a,
+  0x6f, 0x6e, 0x65, 0x3d, 0x30, 0x5d, 0x3c, 0x2f, 0x6c, 0x69, 0x3e, 0x0a,
+  0x20, 0x20, 0x3c, 0x6c, 0x69, 0x3e, 0x2f, 0x63, 0x61, 0x6c, 0x3f, 0x73,
+  0x61, 0x76, 0x65, 0x20, 0x7c, 0x20, 0x2f, 0x63, 0x61, 0x6c, 0x3f, 0x6c,
+  0x6f, 0x61, 0x64, 0x20, 0x7c, 0x20, 0x2f, 0x63, 0x61, 0x6c, 0x3f, 0x72,
+  0x65, 0x73, 0x65, 0x74, 0x20, 0x7c, 0x20, 0x2f, 0x63, 0x61, 0x6c, 0x3f,
+  0x73, 0x68, 0x6f, 0x77, 0x3c, 0x2f, 0x6c, 0x69, 0x3e, 0x0a, 0x20, 0x20,
+  0x3c, 0x6c, 0x69, 0x3e, 0x2f, 0x70, 0x72, 0x6f, 0x66, 0x69, 0x6c, 0x65,
+  0x5b, 0x3f, 0x6e, 0x61, 0x6d, 0x65, 0x3d, 0x7c, 0x75, 0x73, 0x65, 0x3d,
+  0x7c, 0x64, 0x65, 0x6c, 0x3d, 0x5d, 0x20, 0x20, 0x28, 0x50, 0x4f, 0x53,
+  0x54, 0x3a, 0x20, 0x63, 0x61, 0x6d, 0x70, 0x6f, 0x73, 0x20, 0x64, 0x6f,
+  0x20, 0x70, 0x65, 0x72, 0x66, 0x69, 0x6c, 0x29, 0x3c, 0x2f, 0x6c, 0x69,
+  0x3e, 0x0a, 0x20, 0x20, 0x3c, 0x6c, 0x69, 0x3e, 0x2f, 0x70, 0x75, 0x6d,
+  0x70, 0x3f, 0x7a, 0x6f, 0x6e, 0x65, 0x3d, 0x30, 0x26, 0x6f, 0x6e, 0x3d,
+  0x31, 0x7c, 0x30, 0x26, 0x6d, 0x73, 0x3d, 0x35, 0x30, 0x30, 0x30, 0x3c,
+  0x2f, 0x6c, 0x69, 0x3e, 0x0a, 0x20, 0x20, 0x3c, 0x6c, 0x69, 0x3e, 0x2f,
+  0x6e, 0x65, 0x74, 0x3c, 0x2f, 0x6c, 0x69, 0x3e, 0x0a, 0x20, 0x20, 0x3c,
+  0x6c, 0x69, 0x3e, 0x2f, 0x68, 0x69, 0x73, 0x74, 0x6f, 0x72, 0x79, 0x3f,
+  0x66, 0x72, 0x6f, 0x6d, 0x3d, 0x26, 0x74, 0x6f, 0x3d, 0x26, 0x73, 0x74,
+  0x65, 0x70, 0x3d, 0x3c, 0x2f, 0x6c, 0x69, 0x3e, 0x0a, 0x20, 0x20, 0x3c,
+  0x6c, 0x69, 0x3e, 0x2f, 0x73, 0x74, 0x72, 0x65, 0x61, 0x6d, 0x20, 0x28,
+  0x53, 0x65, 0x72, 0x76, 0x65, 0x72, 0x2d, 0x53, 0x65, 0x6e, 0x74, 0x20,
+  0x45, 0x76, 0x65, 0x6e, 0x74, 0x73, 0x29, 0x3c, 0x2f, 0x6c, 0x69, 0x3e,
+  0x0a, 0x20, 0x20, 0x3c, 0x6c, 0x69, 0x3e, 0x2f, 0x66, 0x70, 0x67, 0x61,
+  0x3c, 0x2f, 0x6c, 0x69, 0x3e, 0x0a, 0x20, 0x20, 0x3c, 0x6c, 0x69, 0x3e,
+  0x2f, 0x6d, 0x65, 0x74, 0x72, 0x69, 0x63, 0x73, 0x20, 0x28, 0x50, 0x72,
+  0x6f, 0x6d, 0x65, 0x74, 0x68, 0x65, 0x75, 0x73, 0x29, 0x3c, 0x2f, 0x6c,
+  0x69, 0x3e, 0x0a, 0x3c, 0x2f, 0x75, 0x6c, 0x3e, 0x0a
+};
+const uint8_t INDEX_HTML_GZ[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x65, 0x51,
+  0xbb, 0x6e, 0xc3, 0x30, 0x0c, 0xdc, 0xf3, 0x15, 0x6a, 0x06, 0x23, 0x1d,
+  0x0c, 0x3b, 0x2d, 0x0a, 0x14, 0x81, 0x64, 0xa3, 0x43, 0xe6, 0x06, 0x70,
+  0xb7, 0x20, 0x83, 0x2a, 0xd1, 0xb5, 0x00, 0xbd, 0x20, 0xd1, 0x36, 0x52,
+  0xe8, 0x67, 0xfa, 0x2d, 0xfd, 0xb1, 0xaa, 0x4d, 0x32, 0x18, 0x5d, 0x28,
+  0x1e, 0x71, 0x3c, 0xf2, 0x44, 0x7a, 0x27, 0x9d, 0xc0, 0xb3, 0x07, 0x32,
+  0xa0, 0xd1, 0x0d, 0x35, 0x80, 0x9c, 0x88, 0x81, 0x87, 0x08, 0xc8, 0xd6,
+  0x23, 0xf6, 0xe5, 0xf3, 0xba, 0x6a, 0x28, 0x2a, 0xd4, 0xd0, 0xec, 0xbb,
+  0xc3, 0xe3, 0x03, 0xad, 0x2e, 0x60, 0x45, 0x7d, 0xb3, 0xb7, 0xd2, 0x3b,
+  0x65, 0x31, 0xee, 0x68, 0xe5, 0x73, 0x65, 0xd4, 0xcd, 0x8a, 0x10, 0xaa,
+  0x55, 0x53, 0x49, 0x8e, 0xbc, 0xfd, 0x74, 0x16, 0x58, 0x4d, 0xc8, 0xe6,
+  0x45, 0x08, 0xf0, 0xb8, 0x23, 0xdc, 0x7b, 0xad, 0x04, 0x47, 0xe5, 0x6c,
+  0x95, 0xe7, 0x02, 0x96, 0x11, 0x03, 0x70, 0x43, 0x12, 0x69, 0x7b, 0x83,
+  0xec, 0x5d, 0x59, 0x52, 0x36, 0x24, 0x3f, 0xdf, 0x5f, 0x41, 0x39, 0x32,
+  0x6d, 0xef, 0x69, 0x95, 0xe5, 0x6e, 0xaa, 0x82, 0xeb, 0xf6, 0x77, 0x5b,
+  0x16, 0x65, 0x8a, 0x73, 0xd2, 0x32, 0x69, 0x9d, 0x66, 0x48, 0x73, 0x7f,
+  0x2c, 0x2e, 0xc3, 0x4e, 0xff, 0xf8, 0x91, 0x4f, 0x90, 0xf5, 0xff, 0x72,
+  0xed, 0xb8, 0xbc, 0xe5, 0x01, 0xb2, 0xc7, 0x1b, 0x88, 0x83, 0x9b, 0x17,
+  0x9d, 0x3e, 0xb8, 0x5e, 0x69, 0x38, 0xb6, 0x96, 0x1b, 0x60, 0x69, 0x8c,
+  0x39, 0x48, 0xd0, 0xec, 0x94, 0xdd, 0x1c, 0x5e, 0xbb, 0xb7, 0x1d, 0x11,
+  0xdc, 0x78, 0x17, 0x89, 0x74, 0xc4, 0x43, 0xc8, 0xdc, 0xe5, 0xa6, 0x7e,
+  0x34, 0xfe, 0xea, 0xbf, 0x70, 0x96, 0x6d, 0x53, 0x5d, 0x98, 0xc8, 0x9e,
+  0xea, 0xba, 0x5e, 0xd0, 0x2c, 0xe0, 0x02, 0x0f, 0x2a, 0xa2, 0x0b, 0xe7,
+  0xb6, 0x0f, 0xce, 0xb0, 0x02, 0x1d, 0x2b, 0x22, 0x82, 0x67, 0x0b, 0xce,
+  0xf5, 0xcb, 0x36, 0x1d, 0x84, 0x09, 0x42, 0xd9, 0x81, 0x45, 0xb2, 0x9f,
+  0x72, 0x8c, 0xcb, 0x15, 0x7a, 0xff, 0xc1, 0x17, 0x85, 0x7c, 0xdc, 0xa0,
+  0x44, 0xcc, 0x06, 0xb2, 0x3a, 0xe0, 0x00, 0xe3, 0xad, 0x83, 0x56, 0xbf,
+  0xa7, 0xfb, 0x01, 0x2d, 0x6c, 0x96, 0x83, 0x0d, 0x02, 0x00, 0x00
+};
+const char INDEX_HTML_ETAG[] = "\"74f7db83\"";
@@ -0,0 +1,514 @@
+#pragma once
+/*
+ * Lógica de controle do ESP32: aquisição, Sugeno, histerese + fail-safe,
+ * agendamento das bombas por zona, watchdog do /pump, perfis de planta
+ * (profile.h) e configuração em NVS.
+ * Equivalente em software do FPGA/rtl/irrigation_core.vhd (uma zona).
+ *
+ * Usa a API do Arduino diretamente (analogRead, digitalWrite, millis, delay,
+ * DHT, Preferences, portMUX). No ESP32 ela vem do core; no host, de
+ * sim/mock_hal.h (relógio virtual), o que permite replay e benchmark.
+ */
+#include <stdint.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "telemetry.h"
+#include "telemetry_codec.h"
+#include "sugeno.h"
+#include "profile.h"
+#include "metrics.h"
+
+/* ======================== Helpers – leitura/escala ======================== */
+inline int readAvg(int pin, uint8_t n=16){
+  uint32_t acc=0; for(uint8_t i=0;i<n;i++){ acc += analogRead(pin); delay(2); }
+  return acc / n;
+}
+
+// Filtro EMA para estabilizar nível d'água
+inline int emaInt(int prev, int curr, uint8_t alpha_percent = 25){
+  return ( (int)prev*(100-alpha_percent) + (int)curr*alpha_percent ) / 100;
+}
+
+// Converte raw para 0..100% respeitando direção (full pode ser < empty)
+inline int mapPctSmart(int raw, int emptyRef, int fullRef){
+  if (fullRef == emptyRef) return 0;
+  long pct;
+  if (fullRef > emptyRef) pct = ((long)raw - emptyRef) * 100L / ((long)fullRef - emptyRef);
+  else                    pct = ((long)emptyRef - raw) * 100L / ((long)emptyRef - fullRef);
+  if (pct < 0) pct = 0;
+  if (pct > 100) pct = 100;
+  return (int)pct;
+}
+
+/* ======================== Sugeno 0-ordem ======================== */
+// Conjuntos e regras em sugeno.h (IrrigacaoModel); aqui só aplica o teto.
+inline int clampSugMs(const sugeno::Decision &d, int &rule_id_out, int pumpMaxMs){
+  rule_id_out = d.rule;
+  int sug = d.ms;
+  if (sug > pumpMaxMs) sug = pumpMaxMs;
+  if (sug < 0) sug = 0;
+  return sug;
+}
+inline int ruleSugenoMs(uint8_t dry, uint8_t t, uint8_t lz, int &rule_id_out, int pumpMaxMs){
+  const uint8_t in[sugeno::IrrigacaoModel::NVARS] = { dry, t, lz };
+  return clampSugMs(sugeno::Irrigacao::eval(in), rule_id_out, pumpMaxMs);
+}
+// Com as pertinências/singletons do perfil ativo
+inline int ruleSugenoMs(const profile::Active &ap, uint8_t dry, uint8_t t, uint8_t lz, int &rule_id_out){
+  const uint8_t in[sugeno::IrrigacaoModel::NVARS] = { dry, t, lz };
+  return clampSugMs(sugeno::Irrigacao::eval(in, ap.lut, ap.p.ms), rule_id_out, ap.p.par.pumpMaxMs);
+}
+
+/* ======================== Parâmetros ======================== */
+// Zonas por placa (cada uma com sensor de solo + relé próprios). O ADC1 do
+// ESP32 tem 8 canais; acima disso os canais de solo vêm de um multiplexador
+// analógico e os relés de um expansor, mas a lógica abaixo é a mesma.
+#ifndef IRRIGATION_MAX_ZONES
+#define IRRIGATION_MAX_ZONES 8
+#endif
+const uint8_t MAX_ZONES = IRRIGATION_MAX_ZONES;
+
+struct CorePins { int ldr, water; };            // sensores compartilhados
+struct ZonePins { int soil, pump; };
+
+// Limiares/histerese/agendamento (CoreParams) e Sugeno vêm do perfil ativo (profile.h)
+
+// Solo / LDR / nível d'água (raw), ajustados por leitura atual via /cal?type=...
+const CalValues CAL_DEFAULTS = { 4095, 1200, 381, 737, 300, 2200 };
+
+// Snapshot de todas as zonas; z[i] carrega também os campos compartilhados
+struct ZoneSnapshot {
+  uint8_t   n;
+  Telemetry z[MAX_ZONES];
+};
+
+// Configuração persistida: um único blob "cfg" na NVS (1 gravação na flash
+// em vez de uma por chave), lido uma vez no boot. Mudou o layout -> sobe
+// CFG_VERSION; blob de outra versão/tamanho ou com CRC errado é ignorado.
+const uint32_t CFG_MAGIC   = 0x31475249;   // "IRG1"
+const uint16_t CFG_VERSION = 1;
+
+struct ConfigBlob {
+  uint32_t magic;
+  uint16_t version, size;                     // size = sizeof(ConfigBlob) (muda com MAX_ZONES)
+  uint8_t  nZones, nProfiles, active, pad;
+  CalValues cal;                              // LDR/água + defaults de solo
+  int16_t  soilDry[MAX_ZONES], soilWet[MAX_ZONES];
+  profile::Profile prof[profile::MAX_PROFILES];
+  uint32_t crc;                               // CRC-32 dos bytes anteriores
+};
+
+/* ======================== Controlador ======================== */
+// Zonas em struct-of-arrays: a passada de aquisição, a decisão e o
+// agendador percorrem vetores contíguos por campo.
+struct ZoneTable {
+  uint8_t  n = 0;
+  uint8_t  soilPin[MAX_ZONES], pumpPin[MAX_ZONES];
+  int16_t  soilDry[MAX_ZONES], soilWet[MAX_ZONES];     // calibração por zona
+  int16_t  soilRaw[MAX_ZONES];
+  uint8_t  soilPct[MAX_ZONES];
+  uint16_t sugMs[MAX_ZONES];                            // demanda (saída do Sugeno)
+  uint8_t  ruleId[MAX_ZONES];
+  uint8_t  want[MAX_ZONES];                             // estado da histerese
+  uint8_t  on[MAX_ZONES], manual[MAX_ZONES];              // estado lógico da rodada
+  uint8_t  out[MAX_ZONES];                              // estado físico do relé
+  uint32_t runUntil[MAX_ZONES];                         // fim da rodada (0 = sem prazo)
+  uint32_t waitSince[MAX_ZONES];                        // aging enquanto espera vaga
+  uint32_t onSince[MAX_ZONES], onMs[MAX_ZONES];         // tempo de bomba ligada (relé)
+  uint32_t starts[MAX_ZONES];                           // acionamentos do relé
+};
+
+// Sugeno externo por zona (ex.: FPGA via UART, fpga_link.h). Recebe as
+// entradas crisp; retorna false para usar o ruleSugenoMs() local.
+typedef bool (*SugenoFn)(void *ctx, uint8_t zone, uint8_t soilPct, uint8_t tempC,
+                         uint8_t luzPct, uint8_t waterPct, int &ms);
+
+class IrrigationCore {
+public:
+  CalValues  cal = CAL_DEFAULTS;    // soilDry/soilWet aqui = defaults de zona nova
+  ZoneTable  z;
+
+  IrrigationCore(const CorePins &pins, DHT &dht) : pins_(pins), dht_(dht) {
+    nProf_ = profile::presets(profs_);
+    publish(profs_[0]);
+  }
+
+  int addZone(const ZonePins &p){
+    if (z.n >= MAX_ZONES) return -1;
+    uint8_t i = z.n++;
+    z.soilPin[i] = p.soil;  z.pumpPin[i] = p.pump;
+    z.soilDry[i] = cal.soilDry;  z.soilWet[i] = cal.soilWet;
+    z.soilRaw[i] = 0; z.soilPct[i] = 0; z.sugMs[i] = 0; z.ruleId[i] = 0;
+    z.want[i] = 0; z.on[i] = 0; z.manual[i] = 0; z.out[i] = 0; z.runUntil[i] = 0; z.waitSince[i] = 0;
+    z.onSince[i] = 0; z.onMs[i] = 0; z.starts[i] = 0;
+    return i;
+  }
+
+  void setSugeno(SugenoFn fn, void *ctx = nullptr){ sugFn_ = fn; sugCtx_ = ctx; }
+
+  void begin(){
+    for (uint8_t i = 0; i < z.n; i++){
+      pinMode(z.pumpPin[i], OUTPUT);
+      relay(i, false);          // garante desligado (ativo-baixo)
+    }
+  }
+
+  // Calibração completa de uma zona (solo da zona + LDR/água compartilhados)
+  CalValues zoneCal(uint8_t i) const {
+    CalValues c = cal;
+    c.soilDry = z.soilDry[i];  c.soilWet = z.soilWet[i];
+    return c;
+  }
+
+  // Aquisição + decisão + agendamento + saídas. Chamado a taxa fixa pela task.
+  void sample(ZoneSnapshot &out){
+    int soilRaw[MAX_ZONES], ldrRaw, waterRaw;
+    {
+      METRIC_SCOPE(ACQUIRE);
+      acquire(soilRaw, ldrRaw, waterRaw);
+    }
+
+    // DHT com cache (2 s) – o sensor não aceita leituras mais rápidas
+    bool dhtOk=false;
+    if (millis()-lastDhtMs_>=2000){
+      float h, t;
+      {
+        METRIC_SCOPE(DHT_READ);
+        h=dht_.readHumidity(); t=dht_.readTemperature();
+      }
+      if(!isnan(h)&&!isnan(t)&&h>=0&&h<=100&&t>-40&&t<85){ lastHum_=h; lastTemp_=t; dhtOk=true; }
+      lastDhtMs_=millis();
+    } else if(!isnan(lastHum_)&&!isnan(lastTemp_)) dhtOk=true;
+
+    decide(soilRaw, ldrRaw, waterRaw, dhtOk, out);
+  }
+
+  // Passada única sobre todos os canais: cada rodada lê todas as zonas +
+  // LDR + água e só então espera 2 ms, então o custo em tempo é o de UM
+  // readAvg() (16 rodadas; a água acumula 24) independentemente de z.n.
+  void acquire(int soilRaw[], int &ldrRaw, int &waterRaw){
+    uint32_t acc[MAX_ZONES] = {0}, accL = 0, accW = 0;
+    const uint8_t N = 16, NW = 24;
+    for (uint8_t r = 0; r < NW; r++){
+      if (r < N){
+        for (uint8_t i = 0; i < z.n; i++) acc[i] += analogRead(z.soilPin[i]);
+        accL += analogRead(pins_.ldr);
+      }
+      accW += analogRead(pins_.water);
+      delay(2);
+    }
+    for (uint8_t i = 0; i < z.n; i++) soilRaw[i] = acc[i] / N;
+    ldrRaw = accL / N;  waterRaw = accW / NW;
+  }
+
+  // Decisão pura a partir de leituras já feitas (sem ADC/DHT).
+  void decide(const int soilRaw[], int ldrRaw, int waterRaw, bool dhtOk, ZoneSnapshot &out){
+    // perfil lido uma vez por ciclo: uma troca no meio não afeta este ciclo
+    const profile::Active &ap = *prof_.acquire();
+    const CoreParams &par = ap.p.par;
+    int ldrPct = mapPctSmart(ldrRaw, cal.ldrDark, cal.ldrLight);
+
+    // Nível d'água com EMA (reservatório compartilhado)
+    waterRawEma_ = emaInt(waterRawEma_, waterRaw, 25);
+    int waterPct = mapPctSmart(waterRawEma_, cal.waterEmpty, cal.waterFull);
+    bool water_ok = (waterPct >= par.waterMinPct);
+
+    // Fuzzy – entradas crisp (pertinências e regras em sugeno.h)
+    uint8_t t  = (uint8_t)constrain((int)round(dhtOk? lastTemp_ : 25.0f), 0, 50);
+    uint8_t lz = (uint8_t)constrain(ldrPct, 0, 100);
+
+    uint32_t now = millis();
+    for (uint8_t i = 0; i < z.n; i++){
+      z.soilRaw[i] = soilRaw[i];
+      int soilPct  = mapPctSmart(soilRaw[i], z.soilDry[i], z.soilWet[i]);
+      z.soilPct[i] = soilPct;
+      uint8_t dry  = (uint8_t)constrain(100 - soilPct, 0, 100);
+      int rid = 0, ms, ext;
+      {
+        METRIC_SCOPE(SUGENO);
+        ms = ruleSugenoMs(ap, dry, t, lz, rid);
+      }
+      // o FPGA só conhece as regras do sugeno.h: perfil com regras próprias fica no local
+      if (sugFn_ && ap.stdRules && sugFn_(sugCtx_, i, soilPct, t, lz, waterPct, ext)){
+        ms = constrain(ext, 0, par.pumpMaxMs);
+        extHits_++;
+      }
+      z.sugMs[i]  = ms;
+      z.ruleId[i] = rid;        // o FPGA não informa a regra: fica a dominante local
+
+      // Histerese por zona
+      if (!z.want[i]) { if (soilPct <= par.soilOnTh) { z.want[i] = 1; z.waitSince[i] = now; } }
+      else            { if (soilPct >= par.soilOffTh) z.want[i] = 0; }
+    }
+
+    // Agendamento + saídas, atômico em relação ao /pump
+    taskENTER_CRITICAL(&mux_);
+    schedule(now, water_ok, par);
+    taskEXIT_CRITICAL(&mux_);
+
+    out.n = z.n;
+    for (uint8_t i = 0; i < z.n; i++){
+      Telemetry &s  = out.z[i];
+      s.ts_ms       = now;
+      s.soilRaw     = z.soilRaw[i];   s.soilPct  = z.soilPct[i];
+      s.ldrRaw      = ldrRaw;         s.ldrPct   = ldrPct;
+      s.waterRaw    = waterRaw;       s.waterRawEma = waterRawEma_; s.waterPct = waterPct;
+      s.dhtOk       = dhtOk;
+      s.tempC       = dhtOk ? lastTemp_ : NAN;
+      s.humid       = dhtOk ? lastHum_  : NAN;
+      s.pumpOn      = z.on[i];
+      s.pumpMsSug   = z.sugMs[i];
+      s.ruleId      = z.ruleId[i];
+    }
+    prof_.release();
+  }
+
+  // Watchdog do /pump?ms= – verificado no loop(). Rodada agendada vencida é
+  // do schedule() (reagenda sem pulso se a zona ainda quer água); aqui só é
+  // cortada se ninguém a reagendou em pumpMaxMs (task de amostragem parada).
+  void watchdog(){
+    uint32_t now = millis();
+    uint32_t grace = params().pumpMaxMs;
+    taskENTER_CRITICAL(&mux_);
+    for (uint8_t i = 0; i < z.n; i++){
+      if (!z.on[i] || !z.runUntil[i]) continue;
+      int32_t late = (int32_t)(now - z.runUntil[i]);
+      if (late >= 0 && (z.manual[i] || (uint32_t)late >= grace)) stop(i, now);
+    }
+    applyOutputs();
+    taskEXIT_CRITICAL(&mux_);
+  }
+
+  // /pump: liga a zona por ms (0 = até o solo chegar em soilOffTh) ou desliga
+  // agora. Conta no limite de bombas simultâneas: false se não há vaga.
+  bool manualPump(uint8_t i, bool on, int ms){
+    const CoreParams &par = params();
+    if (i >= z.n) return false;
+    if (ms < 0) ms = 0;
+    if (ms > par.pumpMaxMs) ms = par.pumpMaxMs;
+    bool ok = true;
+    taskENTER_CRITICAL(&mux_);
+    if (!on) stop(i, millis());
+    else if (!z.on[i] && running_ >= par.maxPumps) ok = false;
+    else {
+      if (!z.on[i]) running_++;
+      z.on[i] = 1;  z.manual[i] = 1;
+      z.runUntil[i] = ms>0 ? millis() + (uint32_t)ms : 0;
+    }
+    applyOutputs();
+    taskEXIT_CRITICAL(&mux_);
+    return ok;
+  }
+
+  bool     pumpOn(uint8_t i = 0) const { return i < z.n && z.on[i]; }
+  uint8_t  running()       const { return running_; }
+  uint32_t sugenoExtHits() const { return extHits_; }   // decisões vindas do Sugeno externo
+
+  // Tempo total de bomba ligada da zona (inclui a rodada em curso)
+  uint32_t pumpOnMs(uint8_t i) const {
+    return z.onMs[i] + (z.out[i] ? (uint32_t)(millis() - z.onSince[i]) : 0);
+  }
+
+  /* ---------- Perfis de planta (profile.h) ---------- */
+  // Chamar da task do loop (única escritora); o decide() só vê o publicado.
+  const profile::Profile &profile() const { return prof_.peek()->p; }   // ativo
+  const CoreParams       &params()  const { return prof_.peek()->p.par; }
+  uint8_t profileCount() const { return nProf_; }
+  const profile::Profile &profileAt(uint8_t i) const { return profs_[i]; }
+  int activeProfile() const { return active_; }
+
+  int findProfile(const char *name) const {
+    for (uint8_t i = 0; i < nProf_; i++) if (!strncmp(profs_[i].name, name, profile::NAME_LEN)) return i;
+    return -1;
+  }
+
+  // Inclui/atualiza pelo nome (use = passa a ser o ativo). nullptr = ok,
+  // senão o motivo (BAD_*, FULL, BUSY). Se o perfil é ou vira o ativo, publica
+  // antes de tocar no catálogo: com BUSY nada muda. Só em RAM: saveConfig() persiste.
+  const char *putProfile(const profile::Profile &p, bool use = false){
+    if (const char *err = profile::validate(p, MAX_ZONES)) return err;
+    int i = findProfile(p.name);
+    if (i < 0 && nProf_ >= profile::MAX_PROFILES) return "FULL";
+    if ((use || i == active_) && !publish(p)) return "BUSY";
+    if (i < 0) i = nProf_++;
+    profs_[i] = p;
+    if (use) active_ = i;
+    return nullptr;
+  }
+  const char *useProfile(const char *name){
+    int i = findProfile(name);
+    if (i < 0) return "NO_PROFILE";
+    if (!publish(profs_[i])) return "BUSY";
+    active_ = i;
+    return nullptr;
+  }
+  const char *removeProfile(const char *name){
+    int i = findProfile(name);
+    if (i < 0) return "NO_PROFILE";
+    if (i == active_) return "ACTIVE";
+    for (uint8_t k = i; k + 1 < nProf_; k++) profs_[k] = profs_[k + 1];
+    nProf_--;
+    if (active_ > i) active_--;
+    return nullptr;
+  }
+
+  /* ---------- Persistência (NVS) ---------- */
+  // Calibração + perfis num blob só (ConfigBlob): uma gravação na flash
+  void saveConfig(Preferences &prefs, const char* ns){
+    METRIC_SCOPE(NVS_WRITE);
+    ConfigBlob b;
+    memset(&b, 0, sizeof(b));     // padding zerado: CRC determinístico
+    b.magic = CFG_MAGIC;  b.version = CFG_VERSION;  b.size = sizeof(ConfigBlob);
+    b.nZones = z.n;  b.nProfiles = nProf_;  b.active = active_;
+    b.cal = cal;
+    for (uint8_t i = 0; i < z.n; i++){ b.soilDry[i] = z.soilDry[i]; b.soilWet[i] = z.soilWet[i]; }
+    memcpy(b.prof, profs_, sizeof(profs_));
+    b.crc = profile::crc32(&b, offsetof(ConfigBlob, crc));
+
+    prefs.begin(ns, false);
+    prefs.putBytes("cfg", &b, sizeof(b));
+    if (prefs.isKey("SOIL_DRY")){               // migração: chaves soltas do firmware antigo
+      for (uint8_t i = 0; i < MAX_ZONES; i++){
+        char kd[12], kw[12]; soilKeys(i, kd, kw);
+        if (prefs.isKey(kd)) prefs.remove(kd);
+        if (prefs.isKey(kw)) prefs.remove(kw);
+      }
+      const char *old[] = { "LDR_DARK", "LDR_LIGHT", "W_EMPTY", "W_FULL" };
+      for (const char *k : old) if (prefs.isKey(k)) prefs.remove(k);
+    }
+    prefs.end();
+  }
+
+  // Uma leitura no boot (depois dos addZone) ou pelo /cal?type=load. Sem blob
+  // válido tenta as chaves do firmware antigo (só calibração). nullptr = ok,
+  // "NO_DATA" = nada salvo, "BUSY" = o decide() segura o slot do perfil (em
+  // execução; nada foi alterado, tente de novo).
+  const char *loadConfig(Preferences &prefs, const char* ns){
+    ConfigBlob b;
+    prefs.begin(ns, true);
+    bool blob = prefs.getBytesLength("cfg") == sizeof(b) && prefs.getBytes("cfg", &b, sizeof(b)) == sizeof(b);
+    bool legacy = !blob && prefs.isKey("SOIL_DRY");
+    if (legacy){
+      for (uint8_t i = 0; i < z.n; i++){
+        char kd[12], kw[12]; soilKeys(i, kd, kw);
+        z.soilDry[i] = prefs.getInt(kd, z.soilDry[i]);
+        z.soilWet[i] = prefs.getInt(kw, z.soilWet[i]);
+      }
+      cal.ldrDark    = prefs.getInt("LDR_DARK",  cal.ldrDark);
+      cal.ldrLight   = prefs.getInt("LDR_LIGHT", cal.ldrLight);
+      cal.waterEmpty = prefs.getInt("W_EMPTY",   cal.waterEmpty);
+      cal.waterFull  = prefs.getInt("W_FULL",    cal.waterFull);
+    }
+    prefs.end();
+    if (legacy) return nullptr;
+    if (!blob || b.magic != CFG_MAGIC || b.version != CFG_VERSION || b.size != sizeof(b) ||
+        b.crc != profile::crc32(&b, offsetof(ConfigBlob, crc)) ||
+        b.nProfiles == 0 || b.nProfiles > profile::MAX_PROFILES || b.active >= b.nProfiles) return "NO_DATA";
+
+    // perfil inválido (ex.: limites novos no firmware) volta ao de fábrica;
+    // o catálogo é compactado no próprio blob e só vira o atual se publicar
+    uint8_t n = 0;
+    int act = 0;
+    for (uint8_t i = 0; i < b.nProfiles; i++){
+      if (profile::validate(b.prof[i], MAX_ZONES)) continue;
+      if (i == b.active) act = n;
+      b.prof[n++] = b.prof[i];
+    }
+    if (n && !publish(b.prof[act])) return "BUSY";
+
+    cal = b.cal;
+    for (uint8_t i = 0; i < z.n && i < b.nZones; i++){ z.soilDry[i] = b.soilDry[i]; z.soilWet[i] = b.soilWet[i]; }
+    if (n){ memcpy(profs_, b.prof, n * sizeof(profs_[0])); nProf_ = n; active_ = act; }
+    return nullptr;
+  }
+
+  void resetConfig(Preferences &prefs, const char* ns){
+    prefs.begin(ns, false);
+    prefs.clear();
+    prefs.end();
+  }
+
+private:
+  // Relé ATIVO-BAIXO: LOW energiza (fecha NO->COM, liga bomba), HIGH desliga
+  void relay(uint8_t i, bool on){
+    digitalWrite(z.pumpPin[i], on ? LOW : HIGH);
+    uint32_t now = millis();
+    if (on && !z.out[i]){ z.onSince[i] = now; z.starts[i]++; }
+    else if (!on && z.out[i]) z.onMs[i] += now - z.onSince[i];
+    z.out[i] = on;
+  }
+
+  // Só escreve nos relés que mudaram: uma rodada que vence e é reagendada
+  // no mesmo ciclo não gera pulso no relé.
+  void applyOutputs(){
+    for (uint8_t i = 0; i < z.n; i++) if (z.out[i] != z.on[i]) relay(i, z.on[i]);
+  }
+
+  static void soilKeys(uint8_t i, char *kd, char *kw){
+    if (i == 0){ strcpy(kd, "SOIL_DRY"); strcpy(kw, "SOIL_WET"); return; }
+    snprintf(kd, 12, "SD%u", (unsigned)i);
+    snprintf(kw, 12, "SW%u", (unsigned)i);
+  }
+
+  // Monta o slot livre e troca o ponteiro; false se o decide() ainda o usa
+  bool publish(const profile::Profile &p){
+    profile::Active *a = prof_.begin();
+    if (!a) return false;
+    a->build(p);
+    prof_.commit(a);
+    return true;
+  }
+
+  // chamar com mux_ tomado
+  void stop(uint8_t i, uint32_t now){
+    if (z.on[i]) running_--;
+    z.on[i] = 0;  z.manual[i] = 0;  z.runUntil[i] = 0;
+    z.waitSince[i] = now;
+  }
+
+  // Encerra rodadas vencidas/satisfeitas e preenche as vagas livres com as
+  // zonas de maior demanda (saída do Sugeno + aging pela espera). Com o
+  // reservatório abaixo do mínimo nada liga e tudo desliga (fail-safe).
+  void schedule(uint32_t now, bool water_ok, const CoreParams &par){
+    for (uint8_t i = 0; i < z.n; i++){
+      if (!z.on[i]) continue;
+      bool expired = z.runUntil[i] && (int32_t)(now - z.runUntil[i]) >= 0;
+      bool done    = z.manual[i] ? (expired || (!z.runUntil[i] && z.soilPct[i] >= par.soilOffTh))
+                                 : (expired || !z.want[i]);
+      if (!water_ok || done) stop(i, now);
+    }
+    while (water_ok && running_ < par.maxPumps){
+      int best = -1; uint32_t bestScore = 0;
+      for (uint8_t i = 0; i < z.n; i++){
+        if (!z.want[i] || z.on[i]) continue;
+        uint32_t score = z.sugMs[i] + (now - z.waitSince[i]) / AGING_DIV + 1;
+        if (score > bestScore){ bestScore = score; best = i; }
+      }
+      if (best < 0) break;
+      uint32_t run = z.sugMs[best] > par.minRunMs ? z.sugMs[best] : par.minRunMs;
+      z.on[best] = 1;  z.manual[best] = 0;  z.runUntil[best] = now + run;
+      running_++;
+    }
+    applyOutputs();
+  }
+
+  static const uint32_t AGING_DIV = 8;  // 8 s de espera valem 1 s de demanda
+
+  CorePins      pins_;
+  DHT          &dht_;
+  portMUX_TYPE  mux_ = portMUX_INITIALIZER_UNLOCKED;
+  uint8_t       running_ = 0;
+  SugenoFn      sugFn_ = nullptr;
+  void         *sugCtx_ = nullptr;
+  uint32_t      extHits_ = 0;
+
+  profile::Published<profile::Active> prof_;              // publicado (lido pelo decide)
+  profile::Profile                    profs_[profile::MAX_PROFILES];   // catálogo (loop)
+  uint8_t                             nProf_ = 0;
+  int                                 active_ = 0;
+
+  int           waterRawEma_ = 0;
+  float         lastTemp_ = NAN, lastHum_ = NAN;
+  unsigned long lastDhtMs_ = 0;
+};
@@ -0,0 +1,167 @@
+#pragma once
+/*
+ * Instrumentação de baixo custo exportada no /metrics (texto do Prometheus).
+ *
+ * Histogramas log2 de 32 baldes em memória estática, alimentados pelo
+ * contador de ciclos da CPU (CCOUNT no ESP32): um METRIC_SCOPE custa duas
+ * leituras do contador, um clz e quatro somas, sem alocação nem trava. Cada
+ * histograma tem um único escritor (a task que executa o trecho); o /metrics
+ * pode ler um histograma no meio de uma atualização e ver uma amostra a
+ * menos no _count, o que é aceitável para métricas.
+ *
+ * Com -DIRRIGATION_METRICS=0 os escopos viram no-op e nada é alocado.
+ * Sem dependências do Arduino fora do contador: compila também no host
+ * (lá 1 "ciclo" = 1 ns do steady_clock).
+ */
+#ifndef IRRIGATION_METRICS
+#define IRRIGATION_METRICS 1
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <type_traits>
+#if IRRIGATION_METRICS && !defined(ARDUINO_ARCH_ESP32)
+#include <chrono>
+#endif
+
+namespace metrics {
+
+// Trechos medidos (ordem = índice do histograma)
+enum Op : uint8_t { ACQUIRE, DHT_READ, SUGENO, JSON_FORMAT, HTTP_SEND, NVS_WRITE, LOOP_GAP, NOPS };
+const char *const OP_NAMES[NOPS] = {
+  "acquire", "dht_read", "sugeno", "json_format", "http_send", "nvs_write", "loop_gap"
+};
+
+#if IRRIGATION_METRICS
+
+#ifdef ARDUINO_ARCH_ESP32
+inline uint32_t cycles(){ return ESP.getCycleCount(); }
+inline uint32_t cyclesPerUs(){ return getCpuFrequencyMhz(); }
+#else
+inline uint32_t cycles(){
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+inline uint32_t cyclesPerUs(){ return 1000; }
+#endif
+
+struct Histo {
+  uint32_t b[32];          // b[i]: amostras com 2^i <= ciclos < 2^(i+1)
+  uint32_t n, max;
+  uint64_t sum;            // ciclos
+
+  void add(uint32_t c){
+    b[31 - __builtin_clz(c | 1)]++;
+    n++;
+    sum += c;
+    if (c > max) max = c;
+  }
+};
+
+struct Registry { Histo op[NOPS]; };
+
+// estático com inicialização constante: sem guarda nem construtor
+inline Registry &reg(){ static Registry r; return r; }
+inline void record(Op op, uint32_t c){ reg().op[op].add(c); }
+
+class Scope {
+public:
+  explicit Scope(Op op) : op_(op), t0_(cycles()) {}
+  ~Scope(){ record(op_, cycles() - t0_); }
+private:
+  Op       op_;
+  uint32_t t0_;
+};
+
+// Intervalo entre chamadas consecutivas (jitter do loop()); chamar uma vez por volta
+inline void loopTick(){
+  static uint32_t last = 0;
+  uint32_t c = cycles();
+  if (last) record(LOOP_GAP, c - last);
+  last = c;
+}
+
+#define METRIC_CAT2_(a, b) a##b
+#define METRIC_CAT_(a, b)  METRIC_CAT2_(a, b)
+#define METRIC_SCOPE(op)   metrics::Scope METRIC_CAT_(metricScope_, __LINE__)(metrics::op)
+
+/* ---------------- exportação (texto do Prometheus) ---------------- */
+// Formata em blocos de 512 B e entrega cada bloco a sink(const char*, size_t)
+// (no sketch: server.sendContent, resposta chunked).
+template <class Sink>
+class PromWriter {
+public:
+  static const uint8_t FIRST_BUCKET = 6;    // 64 ciclos; abaixo disso vai tudo no 1º "le"
+
+  explicit PromWriter(Sink sink) : sink_(sink) {}
+
+  void printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    for (int tries = 0; tries < 2; tries++){
+      va_list ap; va_start(ap, fmt);
+      int k = vsnprintf(buf_ + n_, sizeof(buf_) - n_, fmt, ap);
+      va_end(ap);
+      if (k < 0) return;
+      if ((size_t)k < sizeof(buf_) - n_){ n_ += k; return; }
+      if (!n_){ n_ = sizeof(buf_) - 1; return; }     // linha maior que o bloco: trunca
+      flush();
+    }
+  }
+
+  void meta(const char *name, const char *type, const char *help){
+    printf("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+  }
+  // Contadores/gauges inteiros saem exatos (%.6g perderia dígitos depois de
+  // 10^6 e o rate() andaria em degraus); ponto flutuante com 9 dígitos.
+  template <class T>
+  typename std::enable_if<std::is_integral<T>::value>::type
+  value(const char *name, T v, const char *label = nullptr, const char *lv = nullptr){
+    char num[24];
+    if (std::is_signed<T>::value) snprintf(num, sizeof(num), "%lld", (long long)v);
+    else                          snprintf(num, sizeof(num), "%llu", (unsigned long long)v);
+    if (label) printf("%s{%s=\"%s\"} %s\n", name, label, lv, num);
+    else       printf("%s %s\n", name, num);
+  }
+  void value(const char *name, double v, const char *label = nullptr, const char *lv = nullptr){
+    if (label) printf("%s{%s=\"%s\"} %.9g\n", name, label, lv, v);
+    else       printf("%s %.9g\n", name, v);
+  }
+
+  // Todos os histogramas do registro como uma família com rótulo op=
+  void histograms(const Registry &r){
+    const double sPerCycle = 1e-6 / cyclesPerUs();
+    meta("irrig_op_duration_seconds", "histogram", "Duração dos trechos instrumentados.");
+    for (uint8_t o = 0; o < NOPS; o++){
+      const Histo &h = r.op[o];
+      uint32_t acc = 0;
+      for (uint8_t i = 0; i < 32; i++){
+        acc += h.b[i];
+        if (i < FIRST_BUCKET) continue;
+        printf("irrig_op_duration_seconds_bucket{op=\"%s\",le=\"%.3g\"} %u\n",
+               OP_NAMES[o], (double)(2ULL << i) * sPerCycle, (unsigned)acc);
+      }
+      printf("irrig_op_duration_seconds_bucket{op=\"%s\",le=\"+Inf\"} %u\n", OP_NAMES[o], (unsigned)h.n);
+      printf("irrig_op_duration_seconds_sum{op=\"%s\"} %.9g\n", OP_NAMES[o], h.sum * sPerCycle);
+      printf("irrig_op_duration_seconds_count{op=\"%s\"} %u\n", OP_NAMES[o], (unsigned)h.n);
+    }
+    meta("irrig_op_duration_max_seconds", "gauge", "Pior duração observada por trecho.");
+    for (uint8_t o = 0; o < NOPS; o++) value("irrig_op_duration_max_seconds", r.op[o].max * sPerCycle, "op", OP_NAMES[o]);
+  }
+
+  void flush(){ if (n_){ sink_(buf_, n_); n_ = 0; } }
+
+private:
+  Sink   sink_;
+  char   buf_[512];
+  size_t n_ = 0;
+};
+
+#else   // IRRIGATION_METRICS == 0
+
+inline void loopTick(){}
+#define METRIC_SCOPE(op) do {} while (0)
+
+#endif
+
+}  // namespace metrics
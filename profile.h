@@ -0,0 +1,187 @@
+#pragma once
+/*
+ * Perfis de planta: tudo que o controlador usa para decidir, num struct POD
+ * por planta — limiares/histerese/agendamento (CoreParams), pontos a-b-c dos
+ * conjuntos e singletons das regras do Sugeno (sugeno.h).
+ *
+ * Troca em tempo de execução sem reflash: o perfil novo é validado, montado
+ * (com a LUT das pertinências) num slot que o laço de controle não está
+ * usando e publicado com UMA troca de ponteiro (Published<T>). O decide()
+ * pega o ponteiro uma vez por ciclo, então nunca vê um perfil pela metade.
+ *
+ * Persistência (blob único com CRC na NVS) em irrigation_core.h.
+ * Sem dependências do Arduino: compila também no host.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include "sugeno.h"
+
+// Fail-safe, histerese e agendamento (consistentes com o dashboard)
+struct CoreParams {
+  int waterMinPct;   // mínimo de água no reservatório
+  int soilOnTh;      // zona quer água quando solo ≤ soilOnTh %
+  int soilOffTh;     // zona satisfeita quando solo ≥ soilOffTh %
+  int pumpMaxMs;     // teto de segurança
+  int maxPumps;      // bombas ligadas ao mesmo tempo (limite da fonte)
+  int minRunMs;      // rodada mínima (temporização mínima, RF-08)
+};
+const CoreParams CORE_DEFAULTS = { 15, 65, 70, 20000, 1, 3000 };
+
+namespace profile {
+
+typedef sugeno::IrrigacaoModel Model;
+
+const uint8_t NAME_LEN     = 16;
+const uint8_t MAX_PROFILES = 4;
+const int     MS_LIMIT     = 60000;   // sugMs é uint16 no ZoneTable
+
+struct Profile {
+  char       name[NAME_LEN];          // [a-z0-9_-], terminado em NUL
+  CoreParams par;
+  uint8_t    mf[Model::NSETS][3];     // a-b-c de cada conjunto (ordem de Model::Set)
+  int32_t    ms[Model::NRULES];       // singleton de cada regra (R1..R8)
+};
+
+// Nomes dos conjuntos no /profile (mf_<nome>=a,b,c)
+const char *const SET_NAMES[Model::NSETS] = {
+  "dry_low", "dry_med", "dry_high", "t_frio", "t_agrad", "t_quente", "l_escuro", "l_nubl", "l_sol"
+};
+
+// Perfil com as pertinências do sugeno.h e singletons escalados em msPct %
+inline Profile make(const char *name, const CoreParams &par, int msPct = 100){
+  Profile p = {};
+  strncpy(p.name, name, NAME_LEN - 1);
+  p.par = par;
+  for (int s = 0; s < Model::NSETS; s++){
+    p.mf[s][0] = Model::SETS[s].a;  p.mf[s][1] = Model::SETS[s].b;  p.mf[s][2] = Model::SETS[s].c;
+  }
+  for (int r = 0; r < Model::NRULES; r++) p.ms[r] = Model::RULES[r].ms * msPct / 100;
+  return p;
+}
+
+// Perfis de fábrica (o 1º é o comportamento original do firmware)
+inline uint8_t presets(Profile out[MAX_PROFILES]){
+  out[0] = make("padrao",    CORE_DEFAULTS);
+  out[1] = make("suculenta", { 15, 30, 45,  8000, 1, 2000 }, 40);
+  out[2] = make("hortalica", { 15, 70, 80, 20000, 1, 4000 }, 125);
+  return 3;
+}
+
+inline bool validName(const char *n){
+  size_t len = strnlen(n, NAME_LEN);
+  if (len == 0 || len >= NAME_LEN) return false;
+  for (size_t i = 0; i < len; i++){
+    char c = n[i];
+    if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-')) return false;
+  }
+  return true;
+}
+
+// nullptr se o perfil pode ser publicado; senão o motivo (corpo do 400)
+inline const char *validate(const Profile &p, uint8_t maxZones){
+  const CoreParams &c = p.par;
+  if (!validName(p.name))                                      return "BAD_NAME";
+  if (c.waterMinPct < 0 || c.waterMinPct > 100)                return "BAD_WATER_MIN";
+  if (c.soilOnTh < 0 || c.soilOffTh > 100 || c.soilOnTh >= c.soilOffTh) return "BAD_SOIL_TH";
+  if (c.pumpMaxMs < 1000 || c.pumpMaxMs > MS_LIMIT)            return "BAD_PUMP_MAX";
+  if (c.maxPumps < 1 || c.maxPumps > maxZones)                 return "BAD_MAX_PUMPS";
+  if (c.minRunMs < 0 || c.minRunMs > c.pumpMaxMs)              return "BAD_MIN_RUN";
+  for (int s = 0; s < Model::NSETS; s++){
+    const uint8_t *m = p.mf[s];
+    if (m[0] > m[1] || m[1] > m[2] || m[0] == m[2])            return "BAD_MF";
+  }
+  for (int r = 0; r < Model::NRULES; r++)
+    if (p.ms[r] < 0 || p.ms[r] > MS_LIMIT)                     return "BAD_RULE_MS";
+  return nullptr;
+}
+
+// Pronto para o laço de controle; imutável depois de publicado
+struct Active {
+  Profile p;
+  sugeno::LutTable<Model::NSETS> lut;
+  bool    stdRules;     // pertinências/singletons = sugeno.h (o Sugeno do FPGA vale)
+
+  void build(const Profile &src){
+    p = src;
+    stdRules = true;
+    for (int s = 0; s < Model::NSETS; s++){
+      sugeno::fillLut(lut, s, p.mf[s][0], p.mf[s][1], p.mf[s][2]);
+      stdRules &= p.mf[s][0] == Model::SETS[s].a && p.mf[s][1] == Model::SETS[s].b && p.mf[s][2] == Model::SETS[s].c;
+    }
+    for (int x = 0; x < 256; x++) lut.mu[Model::NSETS][x] = 255;
+    for (int r = 0; r < Model::NRULES; r++) stdRules &= p.ms[r] == Model::RULES[r].ms;
+  }
+};
+
+// Publicação por troca de ponteiro. Dois slots: o escritor monta o que não
+// está publicado e troca o ponteiro. O leitor (uma task) marca o slot em uso
+// (hazard pointer) enquanto decide; o escritor não reescreve um slot marcado
+// e devolve nullptr em begin() — quem chama responde BUSY e tenta de novo.
+template <class T>
+class Published {
+public:
+  // Leitor (task de amostragem): pegar/soltar uma vez por ciclo
+  const T *acquire(){
+    const T *p;
+    do { p = cur_.load(); hz_.store(p); } while (p != cur_.load());
+    return p;
+  }
+  void release(){ hz_.store(nullptr); }
+
+  // Escritor (loop): a mesma task pode ler o publicado sem marcar
+  const T *peek() const { return cur_.load(std::memory_order_acquire); }
+  T *begin(){
+    T *t = cur_.load() == &slot_[0] ? &slot_[1] : &slot_[0];
+    return hz_.load() == t ? nullptr : t;
+  }
+  void commit(T *t){ cur_.store(t); }
+
+private:
+  T slot_[2];
+  std::atomic<const T*> cur_{nullptr}, hz_{nullptr};
+};
+
+/* ---------------- /profile (JSON e campos do formulário) ---------------- */
+// Mesmas chaves nos dois sentidos: water_min, soil_on, soil_off, pump_max_ms,
+// max_pumps, min_run_ms, mf_<conjunto>=a,b,c e rules_ms=R1,...,R8
+inline size_t formatProfileJson(char *buf, size_t n, const Profile &p, bool active){
+  const CoreParams &c = p.par;
+  int k = snprintf(buf, n,
+    "{\"name\":\"%s\",\"active\":%s,\"water_min\":%d,\"soil_on\":%d,\"soil_off\":%d,"
+    "\"pump_max_ms\":%d,\"max_pumps\":%d,\"min_run_ms\":%d,\"mf\":{",
+    p.name, active ? "true" : "false", c.waterMinPct, c.soilOnTh, c.soilOffTh, c.pumpMaxMs, c.maxPumps, c.minRunMs);
+  for (int s = 0; s < Model::NSETS && k > 0 && (size_t)k < n; s++)
+    k += snprintf(buf + k, n - k, "%s\"%s\":[%u,%u,%u]", s ? "," : "", SET_NAMES[s], p.mf[s][0], p.mf[s][1], p.mf[s][2]);
+  for (int r = 0; r < Model::NRULES && k > 0 && (size_t)k < n; r++)
+    k += snprintf(buf + k, n - k, "%s%ld", r ? "," : "},\"rules_ms\":[", (long)p.ms[r]);
+  if (k > 0 && (size_t)k < n) k += snprintf(buf + k, n - k, "]}");
+  return (k > 0 && (size_t)k < n) ? (size_t)k : 0;
+}
+
+// "a,b,c" -> out[0..cnt-1]; false se faltar/sobrar número
+inline bool parseList(const char *s, long out[], int cnt){
+  for (int i = 0; i < cnt; i++){
+    char *end;
+    out[i] = strtol(s, &end, 10);
+    if (end == s || *end != (i + 1 < cnt ? ',' : '\0')) return false;
+    s = end + 1;
+  }
+  return true;
+}
+
+// CRC-32 (IEEE 802.3), bit a bit: só roda no boot e ao salvar
+inline uint32_t crc32(const void *data, size_t n){
+  const uint8_t *p = (const uint8_t*)data;
+  uint32_t c = 0xFFFFFFFFu;
+  while (n--){
+    c ^= *p++;
+    for (int k = 0; k < 8; k++) c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1)));
+  }
+  return ~c;
+}
+
+}  // namespace profile
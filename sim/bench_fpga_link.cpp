@@ -0,0 +1,84 @@
+// Troca ESP32 <-> FPGA no modelo ciclo-aproximado: quadro único com as 5
+// leituras em voo (fpga_link.h) x uma ida e volta por registrador.
+// Latência no relógio virtual, com espera ativa (passo de 20 us) e com
+// vTaskDelay(1) (tick de 1 ms, como no sketch); mais o custo de CPU no host.
+#include <stdio.h>
+#include <chrono>
+#include "mock_hal.h"
+#include "fpga_model.h"
+#include "fpga_link.h"
+
+typedef FpgaLink<FpgaModel> Link;
+const int N = 2000;
+
+struct Lat { double avgUs, maxUs; };
+
+static Lat pipelined(uint32_t baud, uint32_t stepUs){
+  hal::reset();
+  FpgaModel fpga; fpga.baud = baud;
+  Link link(fpga);
+  double sum = 0, mx = 0;
+  for (int i = 0; i < N; i++){
+    FpgaInputs in = { (uint8_t)(i % 100), 25, 60, 80 };
+    uint64_t t0 = hal::nowUs;
+    link.start(in, micros());
+    while (!link.poll(micros())) hal::nowUs += stepUs;
+    double us = (double)(hal::nowUs - t0);
+    sum += us; if (us > mx) mx = us;
+    delay(500);
+  }
+  return { sum / N, mx };
+}
+
+// Um registrador por vez: escreve o que precisa e espera cada resposta
+static Lat sequential(uint32_t baud, uint32_t stepUs){
+  using namespace fpga;
+  hal::reset();
+  FpgaModel fpga; fpga.baud = baud;
+  double sum = 0, mx = 0;
+  const uint8_t regs[5] = { ADR_PUMP, ADR_MS_L, ADR_MS_H, ADR_FAULT, ADR_STAT };
+  for (int i = 0; i < N; i++){
+    uint64_t t0 = hal::nowUs;
+    const uint8_t w[15] = { CMD_WRITE, ADR_SOIL, (uint8_t)(i % 100), CMD_WRITE, ADR_TEMP, 25,
+                            CMD_WRITE, ADR_LIGHT, 60, CMD_WRITE, ADR_WATER, 80,
+                            CMD_WRITE, ADR_CTRL, CTRL_WD_KICK };
+    fpga.write(w, sizeof(w));
+    for (uint8_t r : regs){
+      const uint8_t q[3] = { CMD_READ, r, 0 };
+      fpga.write(q, sizeof(q));
+      while (!fpga.available()) hal::nowUs += stepUs;
+      fpga.read();
+    }
+    double us = (double)(hal::nowUs - t0);
+    sum += us; if (us > mx) mx = us;
+    delay(500);
+  }
+  return { sum / N, mx };
+}
+
+int main(){
+  printf("bench_fpga_link: %d trocas por linha (4 escritas + kick + 5 leituras)\n", N);
+  printf("  %7s  %-14s  %-24s  %-24s  %s\n", "baud", "espera", "quadro único (méd/máx)", "1 reg. por vez (méd/máx)", "ganho");
+  const uint32_t bauds[] = { 115200, 460800, 921600 };
+  const uint32_t steps[] = { 20, 1000 };
+  for (uint32_t b : bauds)
+    for (uint32_t s : steps){
+      Lat p = pipelined(b, s), q = sequential(b, s);
+      printf("  %7u  %-14s  %8.0f / %6.0f us      %8.0f / %6.0f us      %4.1fx\n",
+             b, s == 20 ? "ativa 20 us" : "vTaskDelay(1)", p.avgUs, p.maxUs, q.avgUs, q.maxUs, q.avgUs / p.avgUs);
+    }
+
+  // CPU do lado ESP32 por troca (montagem do quadro + decodificação), no host
+  hal::reset();
+  FpgaModel fpga;
+  Link link(fpga);
+  auto w0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++){
+    link.start({ (uint8_t)(i % 100), 25, 60, 80 }, micros());
+    delay(5);
+    link.poll(micros());
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - w0).count() / N;
+  printf("  host: %.0f ns por troca (cliente + modelo), %u timeouts\n", ns, link.timeouts());
+  return link.timeouts() ? 1 : 0;
+}
@@ -0,0 +1,206 @@
+// Carga no http_server.h com sockets TCP locais: GET /data (JSON do último
+// snapshot, formatado uma vez por amostra e reaproveitado) com 1, 8 e 32
+// clientes simultâneos, req/s e latência p50/p99 por requisição.
+//   - base: 1 slot e sem keep-alive, um cliente por vez e conexão nova a cada
+//     requisição (como o WebServer do core atendia);
+//   - novo: 4 slots (HTTP_MAX_CONN do firmware), keep-alive;
+//   - novo com um cliente lento (manda meia requisição e para) ocupando um slot.
+// No host o laço do servidor roda numa thread; PosixNet::idle() dorme no
+// poll() quando nada anda, como o loop() do ESP32 cederia a CPU.
+// Sai com erro se alguma resposta vier diferente de 200.
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <thread>
+#include <vector>
+#include "http_server.h"
+#include "telemetry_codec.h"
+
+typedef std::chrono::steady_clock Clock;
+static const Clock::time_point T0 = Clock::now();
+static uint32_t nowMs(){ return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - T0).count(); }
+
+/* ---------------- transporte POSIX não bloqueante ---------------- */
+struct PosixNet {
+  struct Client {
+    int fd = -1;
+    std::set<int> *open = nullptr;
+    explicit operator bool() const { return fd >= 0; }
+    bool connected(){
+      char b;
+      if (fd < 0) return false;
+      ssize_t r = recv(fd, &b, 1, MSG_PEEK | MSG_DONTWAIT);
+      return r > 0 || (r < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+    }
+    int available(){ int n = 0; return fd >= 0 && ioctl(fd, FIONREAD, &n) == 0 ? n : 0; }
+    int read(uint8_t *b, size_t n){ return (int)recv(fd, b, n, MSG_DONTWAIT); }
+    size_t write(const uint8_t *b, size_t n){
+      ssize_t w = send(fd, b, n, MSG_DONTWAIT | MSG_NOSIGNAL);
+      return w > 0 ? (size_t)w : 0;
+    }
+    void stop(){ if (fd >= 0){ open->erase(fd); close(fd); fd = -1; } }
+  };
+
+  int lfd;
+  uint16_t port;
+  std::set<int> open;
+
+  PosixNet(){
+    lfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    int one = 1;
+    setsockopt(lfd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in a = {};
+    a.sin_family = AF_INET;  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(lfd, (sockaddr*)&a, sizeof(a));
+    listen(lfd, 128);
+    socklen_t len = sizeof(a);
+    getsockname(lfd, (sockaddr*)&a, &len);
+    port = ntohs(a.sin_port);
+  }
+  ~PosixNet(){ for (int fd : open) close(fd); close(lfd); }
+
+  Client accept(){
+    Client c;
+    c.fd = accept4(lfd, nullptr, nullptr, SOCK_NONBLOCK);
+    if (c.fd >= 0){
+      int one = 1;
+      setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+      c.open = &open;
+      open.insert(c.fd);
+    }
+    return c;
+  }
+  void wait(){ usleep(100); }
+
+  // sem trabalho: dorme até chegar conexão ou dado (máx. 1 ms)
+  void idle(){
+    std::vector<pollfd> p;
+    p.push_back({ lfd, POLLIN, 0 });
+    for (int fd : open) p.push_back({ fd, POLLIN, 0 });
+    ::poll(p.data(), p.size(), 1);
+  }
+};
+
+/* ---------------- aplicação: /data com corpo cacheado ---------------- */
+const uint32_t SAMPLE_PERIOD_MS = 500;
+static http::CachedBody<512> dataCache;
+static uint32_t formats = 0;
+static void *srvPtr;
+
+template <class S>
+static void handleData(){
+  S &s = *(S*)srvPtr;
+  uint32_t seq = nowMs() / SAMPLE_PERIOD_MS + 1;          // "snapshot" novo a cada 500 ms
+  CalValues c = { 4095, 1200, 200, 3800, 300, 2200 };
+  if (!dataCache.fresh(0, seq, calTag(c))){
+    Telemetry t = {};
+    t.soilRaw = 2500; t.soilPct = 55; t.ldrRaw = 1800; t.ldrPct = 48; t.waterRaw = t.waterRawEma = 2100;
+    t.waterPct = 95; t.tempC = 24.5f; t.humid = 61; t.dhtOk = true; t.pumpMsSug = 8000; t.ruleId = 4; t.seq = seq;
+    dataCache.store(0, seq, calTag(c), formatTelemetryJson(dataCache.buf, sizeof(dataCache.buf), t, c, 3.3f / 4095));
+    formats++;
+  }
+  s.sendHeader("Access-Control-Allow-Origin", "*");
+  s.send(200, "application/json", dataCache.buf, dataCache.len);
+}
+
+/* ---------------- clientes ---------------- */
+static int dial(uint16_t port){
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  timeval tv = { 3, 0 };
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  sockaddr_in a = {};
+  a.sin_family = AF_INET;  a.sin_addr.s_addr = htonl(INADDR_LOOPBACK);  a.sin_port = htons(port);
+  if (connect(fd, (sockaddr*)&a, sizeof(a))){ close(fd); return -1; }
+  return fd;
+}
+
+struct Load { std::vector<double> latUs; uint32_t errors = 0; };
+
+// Requisições em sequência até o prazo; reconecta quando o servidor fecha
+static void client(uint16_t port, Clock::time_point until, Load &out){
+  static const char REQ[] = "GET /data HTTP/1.1\r\nHost: bench\r\n\r\n";
+  char buf[2048];
+  int fd = -1;
+  while (Clock::now() < until){
+    auto t0 = Clock::now();
+    if (fd < 0 && (fd = dial(port)) < 0){ out.errors++; continue; }
+    if (send(fd, REQ, sizeof(REQ) - 1, MSG_NOSIGNAL) != sizeof(REQ) - 1){ close(fd); fd = -1; out.errors++; continue; }
+    size_t len = 0, need = 0;
+    const char *hdrEnd = nullptr;
+    while (!need || len < need){
+      ssize_t r = recv(fd, buf + len, sizeof(buf) - 1 - len, 0);
+      if (r <= 0) break;
+      len += r;  buf[len] = 0;
+      if (!hdrEnd && (hdrEnd = strstr(buf, "\r\n\r\n"))){
+        const char *cl = strstr(buf, "Content-Length: ");
+        need = (hdrEnd + 4 - buf) + (cl ? strtoul(cl + 16, nullptr, 10) : 0);
+      }
+    }
+    if (!need || len < need || strncmp(buf, "HTTP/1.1 200", 12)){ close(fd); fd = -1; out.errors++; continue; }
+    out.latUs.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+    if (strstr(buf, "Connection: close")){ close(fd); fd = -1; }
+  }
+  if (fd >= 0) close(fd);
+}
+
+template <uint8_t SLOTS>
+static bool run(const char *name, bool keepAlive, int nClients, bool slowClient, double seconds = 0.5){
+  typedef http::Server<PosixNet, SLOTS> S;
+  PosixNet net;
+  S *s = new S(net);
+  srvPtr = s;
+  s->keepAlive = keepAlive;
+  s->on("/data", http::GET, handleData<S>);
+
+  std::atomic<bool> stop{false};
+  std::thread srv([&]{ while (!stop){ if (!s->poll(nowMs())) net.idle(); } });
+
+  int slow = -1;
+  if (slowClient){
+    slow = dial(net.port);
+    send(slow, "GET /data HTTP/1.1\r\nHo", 22, MSG_NOSIGNAL);
+  }
+
+  std::vector<Load> loads(nClients);
+  std::vector<std::thread> cl;
+  auto until = Clock::now() + std::chrono::microseconds((long)(seconds * 1e6));
+  for (int i = 0; i < nClients; i++) cl.emplace_back(client, net.port, until, std::ref(loads[i]));
+  for (auto &t : cl) t.join();
+  stop = true;
+  srv.join();
+  if (slow >= 0) close(slow);
+
+  std::vector<double> lat;
+  uint32_t errors = 0;
+  for (auto &l : loads){ lat.insert(lat.end(), l.latUs.begin(), l.latUs.end()); errors += l.errors; }
+  std::sort(lat.begin(), lat.end());
+  double p50 = lat.empty() ? 0 : lat[lat.size() / 2], p99 = lat.empty() ? 0 : lat[lat.size() * 99 / 100];
+  printf("  %-22s %3d clientes: %8.0f req/s  p50 %7.0f us  p99 %7.0f us  conexões %5u  erros %u\n",
+         name, nClients, lat.size() / seconds, p50, p99, s->accepted(), errors);
+  delete s;
+  return errors == 0 && !lat.empty();
+}
+
+int main(){
+  printf("bench_http: GET /data, %u ms por cenário\n", 500);
+  bool ok = true;
+  for (int n : { 1, 8, 32 }) ok &= run<1>("base (1 slot, close)", false, n, false);
+  for (int n : { 1, 8, 32 }) ok &= run<4>("novo (4 slots, k-a)",  true,  n, false);
+  ok &= run<4>("novo + 1 cliente lento", true, 8, true);
+  printf("  JSON formatado %u vezes (1 por amostra de %u ms, não por requisição)\n", formats, SAMPLE_PERIOD_MS);
+  printf("  %s\n", ok ? "OK" : "ERROS");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+// Custo da instrumentação do metrics.h: ns por METRIC_SCOPE e por loopTick,
+// e a fração que isso representa do trabalho real de CPU de um ciclo do
+// amostrador (decide() de 8 zonas) e do período de 500 ms. No host o
+// "contador de ciclos" é o steady_clock (~20 ns por leitura); no ESP32 é o
+// CCOUNT (1 instrução), então os números aqui são o pior caso.
+// Sai com erro se a instrumentação passar de 1 % do ciclo.
+#include <stdio.h>
+#include <chrono>
+#include "mock_hal.h"
+#include "irrigation_core.h"
+
+const int N = 2000000;
+const uint32_t SAMPLE_PERIOD_MS = 500;
+
+static double nsSince(std::chrono::steady_clock::time_point t0, int n){
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / n;
+}
+
+int main(){
+#if IRRIGATION_METRICS
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++){ METRIC_SCOPE(JSON_FORMAT); }
+  double scopeNs = nsSince(t0, N);
+
+  t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++) metrics::loopTick();
+  double tickNs = nsSince(t0, N);
+
+  // decide() de 8 zonas com os 8 escopos SUGENO dentro
+  hal::reset();
+  DHT dht(22, DHT22);
+  IrrigationCore core({ 35, 39 }, dht);
+  for (uint8_t i = 0; i < 8; i++) core.addZone({ (uint8_t)(12 + i), (uint8_t)(28 + i) });
+  core.begin();
+  ZoneSnapshot snap = {};
+  int soil[8];
+  const int M = 200000;
+  t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < M; i++){
+    for (uint8_t z = 0; z < 8; z++) soil[z] = 1200 + (i * 7 + z * 331) % 2800;
+    core.decide(soil, 737, 2200, false, snap);
+  }
+  double decideNs = nsSince(t0, M);
+
+  // por ciclo: ACQUIRE + 8 SUGENO + DHT a cada 4 ciclos (2 s / 500 ms)
+  double perCycle = scopeNs * (1 + 8 + 0.25);
+  printf("bench_metrics: %d iterações\n", N);
+  printf("  METRIC_SCOPE: %5.1f ns   loopTick: %5.1f ns\n", scopeNs, tickNs);
+  printf("  decide() 8 zonas: %6.0f ns (com 8 escopos = %4.1f %% do custo)\n", decideNs, 100 * 8 * scopeNs / decideNs);
+  printf("  ciclo do amostrador: %.0f ns de instrumentação = %.5f %% de %u ms\n",
+         perCycle, 100 * perCycle / (SAMPLE_PERIOD_MS * 1e6), SAMPLE_PERIOD_MS);
+  bool ok = 100 * perCycle / (SAMPLE_PERIOD_MS * 1e6) < 1.0;
+  printf("  %s\n", ok ? "OK (< 1 %)" : "ACIMA DE 1 %");
+  return ok ? 0 : 1;
+#else
+  printf("bench_metrics: IRRIGATION_METRICS=0, nada a medir\n");
+  return 0;
+#endif
+}
@@ -0,0 +1,114 @@
+// Controlador multi-zona de 1 a 64 zonas (compilado com IRRIGATION_MAX_ZONES=64):
+// custo por ciclo (aquisição em lote no tempo virtual + decisão/agendamento
+// no host) e invariantes do agendador ao longo de 2 dias simulados:
+//   - nunca mais que maxPumps bombas ligadas;
+//   - nada ligado com o reservatório abaixo de waterMinPct;
+//   - espera máxima de uma zona que quer água (aging evita inanição).
+// Sai com erro se alguma invariante quebrar.
+#include <stdio.h>
+#include <math.h>
+#include <chrono>
+#include "mock_hal.h"
+#include "irrigation_core.h"
+
+static_assert(MAX_ZONES >= 64, "compile com -DIRRIGATION_MAX_ZONES=64");
+
+enum { P_LDR = 35, P_WATER = 39, P_SOIL0 = 40, P_PUMP0 = 120 };
+const uint32_t SAMPLE_PERIOD_MS = 500;
+const double   DAYS = 2;
+
+struct Result {
+  double nsPerCycle, acqMs;
+  uint32_t maxOn, onWhileLow, starts;
+  double maxWaitS, dutyPct;
+};
+
+static Result run(uint8_t nz, int maxPumps){
+  hal::reset();
+  DHT dht(22, DHT22);
+  IrrigationCore core({ P_LDR, P_WATER }, dht);
+  for (uint8_t i = 0; i < nz; i++) core.addZone({ P_SOIL0 + i, P_PUMP0 + i });
+  profile::Profile pr = core.profile();
+  pr.par.maxPumps = maxPumps;
+  core.putProfile(pr);
+  core.begin();
+
+  // cada zona seca num ritmo próprio; reservatório compartilhado esvazia com
+  // as bombas e é reabastecido a cada 12 h
+  double soil[MAX_ZONES], rate[MAX_ZONES], water = 100;
+  uint32_t lcg = 12345;
+  for (uint8_t i = 0; i < nz; i++){
+    lcg = lcg * 1664525u + 1013904223u;
+    soil[i] = 60 + (lcg >> 24) % 30;
+    rate[i] = (2.0 + (lcg >> 8) % 600 / 100.0) / 3600;   // 2..8 %/h
+  }
+
+  static ZoneSnapshot snap;
+  Result r = {};
+  double waitS[MAX_ZONES] = {}, nsSum = 0, acqSum = 0, onCycles = 0;
+  uint64_t cycles = 0, nextUs = 0;
+  const uint64_t endUs = (uint64_t)(DAYS * 86400e6);
+  const double dt = SAMPLE_PERIOD_MS / 1000.0;
+  while (hal::nowUs < endUs){
+    double tSec = hal::nowUs / 1e6;
+    double sun = fmax(0, sin((fmod(tSec, 86400) / 86400 - 0.25) * 2 * M_PI));
+    if (fmod(tSec, 43200) < dt) water = 100;
+    for (uint8_t i = 0; i < nz; i++){
+      bool on = core.pumpOn(i);
+      soil[i] = fmin(100, fmax(0, soil[i] + (on ? 0.1 : 0) * dt - rate[i] * (0.5 + sun) * dt));
+      if (on) water = fmax(0, water - 0.002 * dt);
+      hal::adc[P_SOIL0 + i] = (int)(4095 - (4095 - 1200) * soil[i] / 100);
+    }
+    hal::adc[P_LDR]   = (int)(381 + (737 - 381) * sun);
+    hal::adc[P_WATER] = (int)(300 + (2200 - 300) * water / 100);
+    hal::dhtTemp = (float)(18 + 14 * sun);
+
+    int soilRaw[MAX_ZONES], ldrRaw, waterRaw;
+    uint64_t v0 = hal::nowUs;
+    core.acquire(soilRaw, ldrRaw, waterRaw);
+    acqSum += (hal::nowUs - v0) / 1000.0;
+
+    auto w0 = std::chrono::steady_clock::now();
+    core.decide(soilRaw, ldrRaw, waterRaw, false, snap);
+    nsSum += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - w0).count();
+    cycles++;
+
+    // espera só conta com água disponível (sem água ninguém roda, por projeto)
+    bool waterOk = snap.z[0].waterPct >= core.params().waterMinPct;
+    uint32_t on = 0;
+    for (uint8_t i = 0; i < nz; i++){
+      if (snap.z[i].pumpOn){ on++; waitS[i] = 0; }
+      else if (core.z.want[i] && waterOk) { waitS[i] += dt; r.maxWaitS = fmax(r.maxWaitS, waitS[i]); }
+      else waitS[i] = 0;
+    }
+    if (on > r.maxOn) r.maxOn = on;
+    if (on && !waterOk) r.onWhileLow++;
+    onCycles += on;
+
+    nextUs += SAMPLE_PERIOD_MS * 1000ULL;
+    if (hal::nowUs < nextUs) hal::nowUs = nextUs;
+    core.watchdog();
+  }
+  for (uint8_t i = 0; i < nz; i++) r.starts += hal::toggles[P_PUMP0 + i] / 2;
+  r.nsPerCycle = nsSum / cycles;
+  r.acqMs      = acqSum / cycles;
+  r.dutyPct    = 100.0 * onCycles / (cycles * (double)maxPumps);
+  return r;
+}
+
+int main(){
+  const int MAXP = 4;
+  int bad = 0;
+  printf("bench_multizone: %.0f dias simulados, ciclo de %u ms, maxPumps=%d\n", DAYS, SAMPLE_PERIOD_MS, MAXP);
+  printf("  zonas  decisão/ciclo  por zona  aquisição  máx on  on c/ água baixa  acionam.  uso vagas  espera máx\n");
+  const uint8_t NZ[] = { 1, 2, 4, 8, 16, 32, 64 };
+  for (uint8_t nz : NZ){
+    Result r = run(nz, MAXP);
+    bool ok = r.maxOn <= (uint32_t)MAXP && r.onWhileLow == 0;
+    bad += !ok;
+    printf("  %5u  %10.0f ns  %6.0f ns  %6.1f ms  %6u  %15u  %8u  %8.1f%%  %8.0f s%s\n",
+           nz, r.nsPerCycle, r.nsPerCycle / nz, r.acqMs, r.maxOn, r.onWhileLow, r.starts,
+           r.dutyPct, r.maxWaitS, ok ? "" : "  <- VIOLAÇÃO");
+  }
+  return bad ? 1 : 0;
+}
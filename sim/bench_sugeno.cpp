@@ -0,0 +1,44 @@
+// ns/decisão: sugeno.h (LUT + tabela de regras) x tri_mu()/ruleSugenoMs() original.
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+#include "sugeno.h"
+#include "reference_fuzzy.h"
+
+struct In { uint8_t dry, t, lz; };
+
+template <class F>
+static double nsPerCall(const std::vector<In> &v, int reps, F f){
+  volatile uint32_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < reps; r++)
+    for (const In &x : v) sink = sink + f(x);
+  auto t1 = std::chrono::steady_clock::now();
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / ((double)v.size() * reps);
+}
+
+int main(){
+  // entradas em ordem pseudo-aleatória (evita que o preditor decore o padrão)
+  std::vector<In> v;
+  uint32_t x = 12345;
+  for (int i = 0; i < 1 << 16; i++){
+    x = x * 1664525u + 1013904223u;
+    v.push_back({ (uint8_t)((x >> 8) % 101), (uint8_t)((x >> 16) % 51), (uint8_t)((x >> 24) % 101) });
+  }
+  const int REPS = 50;
+
+  double nsRef = nsPerCall(v, REPS, [](const In &i){
+    int rid; return (uint32_t)ref::decide(i.dry, i.t, i.lz, rid) + (uint32_t)rid; });
+  double nsNew = nsPerCall(v, REPS, [](const In &i){
+    const uint8_t in[3] = { i.dry, i.t, i.lz };
+    sugeno::Decision d = sugeno::Irrigacao::eval(in);
+    return (uint32_t)d.ms + d.rule; });
+
+  printf("bench_sugeno (%zu entradas x %d)\n", v.size(), REPS);
+  printf("  original (tri_mu + ruleSugenoMs): %7.2f ns/decisão\n", nsRef);
+  printf("  sugeno.h (LUT + tabela)         : %7.2f ns/decisão\n", nsNew);
+  printf("  speedup                         : %7.2fx\n", nsRef / nsNew);
+  return 0;
+}
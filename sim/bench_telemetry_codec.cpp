@@ -0,0 +1,46 @@
+// /data: snprintf JSON (com calibração) x binário v1 + calTag.
+// Tempo de codificação e bytes no ar (corpo + cabeçalhos HTTP típicos).
+#include <stdio.h>
+#include <chrono>
+#include "telemetry_codec.h"
+
+template <class F>
+static double nsPerCall(int reps, F f){
+  volatile size_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int i = 0; i < reps; i++) sink = sink + f(i);
+  auto t1 = std::chrono::steady_clock::now();
+  (void)sink;
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / reps;
+}
+
+int main(){
+  Telemetry s = {};
+  s.soilRaw = 2710; s.ldrRaw = 512; s.waterRaw = 1800; s.waterRawEma = 1794;
+  s.soilPct = 48; s.ldrPct = 37; s.waterPct = 78;
+  s.dhtOk = true; s.tempC = 27.4f; s.humid = 61.0f;
+  s.pumpOn = true; s.pumpMsSug = 8421; s.ruleId = 4;
+  CalValues c = { 4095, 1200, 381, 737, 300, 2200 };
+  const float VPC = 3.3f / 4095;
+  const int REPS = 200000;
+
+  char json[1150]; uint8_t bin[64];
+  size_t jsonLen = formatTelemetryJson(json, sizeof(json), s, c, VPC);
+  size_t binLen  = encodeTelemetryBin(bin, sizeof(bin), s, calTag(c));
+
+  double nsJson = nsPerCall(REPS, [&](int i){
+    s.seq = i; s.soilRaw = 2000 + (i & 1023);
+    return formatTelemetryJson(json, sizeof(json), s, c, VPC); });
+  double nsBin = nsPerCall(REPS, [&](int i){
+    s.seq = i; s.soilRaw = 2000 + (i & 1023);
+    return encodeTelemetryBin(bin, sizeof(bin), s, calTag(c)); });
+
+  // cabeçalhos de resposta do WebServer + CORS (aprox., iguais nos dois casos)
+  const size_t HDR = 190;
+  printf("bench_telemetry_codec (%d codificações)\n", REPS);
+  printf("  JSON    : %7.1f ns  %4zu B corpo  %4zu B no ar\n", nsJson, jsonLen, jsonLen + HDR);
+  printf("  binário : %7.1f ns  %4zu B corpo  %4zu B no ar\n", nsBin,  binLen,  binLen + HDR);
+  printf("  ganho   : %7.1fx tempo  %5.1fx corpo  %5.1fx no ar\n",
+         nsJson / nsBin, (double)jsonLen / binLen, (double)(jsonLen + HDR) / (binLen + HDR));
+  return 0;
+}
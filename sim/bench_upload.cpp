@@ -0,0 +1,83 @@
+// Envio à nuvem em 24 h (1 registro/min, 2 h de servidor fora no meio):
+// um POST JSON por amostra contra o upload_queue.h (lotes binários).
+// Compara requisições/h, bytes/h e uma estimativa do tempo de rádio ativo:
+// cada requisição custa RTT_ROUNDS idas e voltas (TCP + HTTP + fechamento),
+// os bytes a PHY_KBPS e o rádio fica acordado RADIO_TAIL_MS depois de cada
+// troca (modem sleep só volta após o tráfego parar). Números de modelo, não
+// medidos; o que importa é a razão entre os dois.
+// Sai com erro se o lote não cortar as requisições/h em pelo menos 8x.
+#include <stdio.h>
+#include "upload_queue.h"
+#include "telemetry_codec.h"
+
+struct MemStorage {
+  uint8_t mem[64 * 4096];
+  bool read(uint32_t off, void *buf, size_t n){ memcpy(buf, mem + off, n); return true; }
+  bool write(uint32_t off, const void *buf, size_t n){ memcpy(mem + off, buf, n); return true; }
+};
+typedef HistoryLog<MemStorage> Log;
+
+// Nuvem que responde na volta seguinte; fora do ar = 503
+struct CountingLink {
+  bool down = false, busy = false;
+  bool start(const uint8_t*, size_t, uint32_t){ if (busy) return false; busy = true; return true; }
+  int  poll(uint32_t){ busy = false; return down ? 503 : 200; }
+  bool idle(){ return !busy; }
+};
+
+const double   HTTP_HDR_BYTES = 180;     // requisição + resposta, sem corpo
+const double   RTT_ROUNDS = 4, RTT_MS = 30, PHY_KBPS = 1000, RADIO_TAIL_MS = 200;
+const uint32_t HOURS = 24;
+
+static double radioMs(double requests, double bytes){
+  return requests * (RTT_ROUNDS * RTT_MS + RADIO_TAIL_MS) + bytes * 8 / PHY_KBPS;
+}
+
+static MemStorage st;
+
+int main(){
+  Log log(st);
+  log.begin();
+  CountingLink link;
+  upload::UploadQueue<Log, CountingLink> q(log, link);
+
+  // por amostra: o JSON do /data (o formato que o dashboard já lê)
+  Telemetry t = {};
+  t.soilRaw = 2500; t.soilPct = 55; t.ldrRaw = 1800; t.ldrPct = 48; t.waterRaw = t.waterRawEma = 2100;
+  t.waterPct = 95; t.tempC = 24.5f; t.humid = 61; t.dhtOk = true; t.pumpMsSug = 8000; t.ruleId = 4; t.seq = 123456;
+  CalValues c = { 4095, 1200, 200, 3800, 300, 2200 };
+  char json[640];
+  double jsonBytes = formatTelemetryJson(json, sizeof(json), t, c, 3.3f / 4095);
+  double perReq = 0, perBytes = 0;
+
+  const uint32_t T0 = 1700000000;
+  for (uint32_t s = 0; s < HOURS * 3600; s++){
+    link.down = s >= 10 * 3600 && s < 12 * 3600;
+    if (s % 60 == 0){
+      HistRecord r = {};
+      uint32_t i = s / 60;
+      r.ts = T0 + s;  r.soilRaw = 2500 + i % 37;  r.ldrRaw = 1800 + i % 53;  r.waterRaw = 2100 - i % 29;
+      r.temp_dC = 240 + i % 20;  r.humid_dPct = 600 + i % 40;  r.soilPct = 55;  r.ldrPct = 48;  r.waterPct = 95;
+      r.flags = HIST_DHT_OK;  r.ruleId = 4;
+      log.append(r, r.ts);
+      // por amostra: tenta toda vez; na queda a amostra se perde (sem fila)
+      perReq++;
+      perBytes += jsonBytes + HTTP_HDR_BYTES;
+    }
+    q.tick(s * 1000, T0 + s, true);
+  }
+
+  double batReq = q.requests(), batBytes = q.bytes() + batReq * HTTP_HDR_BYTES;
+  double perRadio = radioMs(perReq, perBytes), batRadio = radioMs(batReq, batBytes);
+  printf("bench_upload: %u h, 1 registro/min, 2 h de servidor fora\n", HOURS);
+  printf("  por amostra (JSON):   %6.1f req/h  %7.0f B/h  rádio ~%5.1f s/h\n",
+         perReq / HOURS, perBytes / HOURS, perRadio / 1000 / HOURS);
+  printf("  em lote (upload_queue): %4.1f req/h  %7.0f B/h  rádio ~%5.1f s/h  (%u falhas, backlog %u, perdidos %u)\n",
+         batReq / HOURS, batBytes / HOURS, batRadio / 1000 / HOURS,
+         (unsigned)q.failures(), (unsigned)q.backlog(), (unsigned)q.lost());
+  printf("  %.0fx menos requisições, %.0fx menos bytes, %.0fx menos rádio\n",
+         perReq / batReq, perBytes / batBytes, perRadio / batRadio);
+  bool ok = perReq / batReq >= 8 && q.lost() == 0 && q.backlog() <= q.BATCH_RECS;
+  printf("  %s\n", ok ? "OK" : "LOTE NÃO REDUZIU O SUFICIENTE");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,188 @@
+#pragma once
+/*
+ * Modelo ciclo-aproximado do lado FPGA para o host: uart_regs_simple.vhd +
+ * fuzzify/rules_sugeno (via sugeno.h) + guard.vhd, ligado ao ESP32 por uma
+ * UART 8N1 nos dois sentidos.
+ *
+ * Tempo em ns, derivado do relógio virtual (hal::nowUs):
+ *   - cada byte ocupa 10 bits no fio; a linha é serial nos dois sentidos;
+ *   - a FSM dos registradores consome o byte 1 ciclo de clk após a chegada;
+ *     como na RTL, a leitura só responde no 3º byte (estado GOT_ADDR), com
+ *     tx_stb no ciclo seguinte; a resposta entra na fila do TX;
+ *   - fuzzify e rules são registrados: pump_ms_sug segue as entradas com 2
+ *     ciclos de atraso;
+ *   - o guard roda no enable de 1 Hz (WD_TIMEOUT_S em segundos). O kick do
+ *     CTRL é um pulso de 1 ciclo de clk; o modelo o segura até o próximo
+ *     tick, que é o alongador de pulso que o top da placa precisa ter;
+ *   - do lado ESP32, bytes recebidos só ficam visíveis em available() após a
+ *     linha ficar ociosa por rxTimeoutSym símbolos (timeout de RX do driver).
+ *
+ * Exposto com a interface do HardwareSerial (write/available/read), então
+ * FpgaLink<FpgaModel> roda sem mudanças. mute = FPGA sem configuração/cabo
+ * solto (nada responde).
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <deque>
+#include "mock_hal.h"
+#include "sugeno.h"
+#include "fpga_link.h"
+
+class FpgaModel {
+public:
+  // UART / clock
+  uint32_t baud = 115200;
+  uint32_t clkHz = 50000000;
+  uint8_t  rxTimeoutSym = 2;
+  bool     mute = false;
+
+  // generics do guard (como instanciado em irrigation_core.vhd)
+  int soilOnTh = 30, soilOffTh = 40, waterMin = 5, pumpMaxMs = 20000, wdTimeoutS = 5;
+
+  /* ---------- lado ESP32 (HardwareSerial) ---------- */
+  size_t write(const uint8_t *b, size_t n){
+    uint64_t now = hal::nowUs * 1000;
+    for (size_t i = 0; i < n; i++){
+      uint64_t arrive = (now > rxLineFree_ ? now : rxLineFree_) + byteNs();
+      rxLineFree_ = arrive;
+      onByte(b[i], arrive + clkNs());
+    }
+    bytesIn_ += n;
+    return n;
+  }
+  int available(){
+    uint64_t now = hal::nowUs * 1000;
+    int n = 0;
+    for (const Reply &r : txQ_){ if (r.visible > now) break; n++; }
+    return n;
+  }
+  int read(){
+    if (!available()) return -1;
+    uint8_t v = txQ_.front().v; txQ_.pop_front();
+    return v;
+  }
+
+  /* ---------- estado interno (para os testes) ---------- */
+  // Avança o guard até o instante atual (sem tráfego na UART).
+  void sync(){ tickTo(hal::nowUs * 1000); }
+
+  uint8_t  soil() const { return soil_; }
+  uint8_t  water() const { return water_; }
+  bool     stateOn() const { return stateOn_; }
+  bool     wdOk() const { return wdOk_; }
+  uint16_t sug() const { return sugNow(lastProcNs_); }
+  uint32_t bytesIn() const { return bytesIn_; }
+  uint32_t bytesOut() const { return bytesOut_; }
+
+  // Saídas combinacionais do guard
+  bool     waterOk() const { return water_ >= waterMin; }
+  bool     pumpOn() const { return stateOn_ && wdOk_ && waterOk(); }
+  uint16_t pumpMs(uint64_t t) const {
+    uint16_t s = sugNow(t);
+    return pumpOn() ? (s > pumpMaxMs ? (uint16_t)pumpMaxMs : s) : 0;
+  }
+  uint8_t fault(uint64_t t) const {
+    using namespace fpga;
+    return (!wdOk_ ? FAULT_WD : 0) | (!waterOk() ? FAULT_WATER : 0) | (sugNow(t) > pumpMaxMs ? FAULT_OVR : 0);
+  }
+  uint8_t status() const {
+    using namespace fpga;
+    return (stateOn_ ? ST_ON : 0) | (soil_ <= soilOnTh ? ST_SOIL_LOW : 0) |
+           (wdOk_ ? ST_WD_OK : 0) | (waterOk() ? ST_WATER_OK : 0);
+  }
+
+private:
+  struct Reply { uint8_t v; uint64_t arrive, visible; };
+  enum { IDLE, GOT_HDR, GOT_ADDR } st_ = IDLE;
+
+  uint64_t byteNs() const { return 10ULL * 1000000000ULL / baud; }
+  uint64_t clkNs()  const { return (1000000000ULL + clkHz - 1) / clkHz; }
+
+  // pump_ms_sug registrado duas vezes (fuzzify -> rules)
+  uint16_t sugNow(uint64_t t) const { return t >= sugValidNs_ ? sugNew_ : sugOld_; }
+  void inputsChanged(uint64_t t){
+    sugOld_ = sugNow(t);
+    uint8_t dry = soil_ > 100 ? 0 : (uint8_t)(100 - soil_);
+    const uint8_t in[sugeno::IrrigacaoModel::NVARS] = { dry, temp_, light_ };
+    sugNew_ = (uint16_t)sugeno::Irrigacao::eval(in).ms;
+    sugValidNs_ = t + 2 * clkNs();
+  }
+
+  // Enable de 1 Hz do guard: registradores com os valores de antes do tick
+  void tickTo(uint64_t t){
+    while (nextTickNs_ <= t){
+      uint16_t cnt = wdCnt_;
+      bool wdOk = wdOk_;
+      wdCnt_ = kick_ ? 0 : (uint16_t)(cnt + 1);
+      kick_  = false;
+      wdOk_  = !(cnt > wdTimeoutS);
+      if (!stateOn_){ if (soil_ <= soilOnTh && wdOk && waterOk()) stateOn_ = true; }
+      else          { if (soil_ >= soilOffTh || !wdOk || !waterOk()) stateOn_ = false; }
+      nextTickNs_ += 1000000000ULL;
+    }
+  }
+
+  // FSM do uart_regs_simple para um byte consumido no instante t
+  void onByte(uint8_t b, uint64_t t){
+    using namespace fpga;
+    tickTo(t);
+    lastProcNs_ = t;
+    switch (st_){
+      case IDLE:
+        if (b == CMD_WRITE){ opWrite_ = true; st_ = GOT_HDR; }
+        else if (b == CMD_READ){ opWrite_ = false; st_ = GOT_HDR; }
+        break;
+      case GOT_HDR:
+        addr_ = b; st_ = GOT_ADDR;
+        break;
+      case GOT_ADDR:
+        if (!opWrite_)               reply(readReg(addr_, t), t + clkNs());
+        else if (addr_ == ADR_SOIL)  { soil_  = b; inputsChanged(t); }
+        else if (addr_ == ADR_TEMP)  { temp_  = b; inputsChanged(t); }
+        else if (addr_ == ADR_LIGHT) { light_ = b; inputsChanged(t); }
+        else if (addr_ == ADR_WATER) { water_ = b; }
+        else if (addr_ == ADR_CTRL)  { if (b & CTRL_WD_KICK) kick_ = true; }
+        st_ = IDLE;
+        break;
+    }
+  }
+
+  uint8_t readReg(uint8_t a, uint64_t t) const {
+    using namespace fpga;
+    switch (a){
+      case ADR_PUMP:  return pumpOn() ? 1 : 0;
+      case ADR_MS_L:  return (uint8_t)pumpMs(t);
+      case ADR_MS_H:  return (uint8_t)(pumpMs(t) >> 8);
+      case ADR_FAULT: return fault(t);
+      case ADR_STAT:  return status();
+      default:        return 0;
+    }
+  }
+
+  // tx_stb: serializa no TX; o driver do ESP32 só entrega após a linha ociosa
+  void reply(uint8_t v, uint64_t t){
+    if (mute) return;
+    uint64_t start = t > txLineFree_ ? t : txLineFree_;
+    txLineFree_ = start + byteNs();
+    Reply r = { v, txLineFree_, txLineFree_ + rxTimeoutSym * byteNs() };
+    // bytes colados ao anterior empurram a visibilidade do grupo inteiro
+    for (auto it = txQ_.rbegin(); it != txQ_.rend() && r.arrive - it->arrive <= byteNs(); ++it)
+      it->visible = r.visible;
+    txQ_.push_back(r);
+    bytesOut_++;
+  }
+
+  bool     opWrite_ = false;
+  uint8_t  addr_ = 0;
+  uint8_t  soil_ = 0, temp_ = 0, light_ = 0, water_ = 0;
+  uint16_t sugOld_ = 0, sugNew_ = 0;
+  uint64_t sugValidNs_ = 0, lastProcNs_ = 0;
+
+  uint16_t wdCnt_ = 0;
+  bool     wdOk_ = true, kick_ = false, stateOn_ = false;
+  uint64_t nextTickNs_ = 1000000000ULL;
+
+  uint64_t rxLineFree_ = 0, txLineFree_ = 0;
+  std::deque<Reply> txQ_;
+  uint32_t bytesIn_ = 0, bytesOut_ = 0;
+};
@@ -0,0 +1,66 @@
+#pragma once
+// Transporte em memória para o http_server.h (test_http, test_upload):
+// cada conexão é um Pipe com os dois sentidos, entrada gotejada (drip) e
+// janela de escrita limitada (budget) para simular rede lenta.
+#include <string.h>
+#include <memory>
+#include <string>
+#include <deque>
+#include <vector>
+
+struct Pipe {
+  std::string in, out;        // cliente -> servidor, servidor -> cliente
+  size_t inOff = 0;
+  size_t drip = 0;            // bytes visíveis por available() (0 = tudo)
+  size_t budget = (size_t)-1; // bytes que o "socket" ainda aceita
+  size_t refill = 0;          // quanto o wait() devolve ao budget (o par leu)
+  bool   open = true;
+};
+
+struct MemNet {
+  struct Client {
+    std::shared_ptr<Pipe> p;
+    explicit operator bool() const { return (bool)p; }
+    bool connected(){ return p && p->open; }
+    int available(){
+      if (!p) return 0;
+      size_t n = p->in.size() - p->inOff;
+      return (int)(p->drip && n > p->drip ? p->drip : n);
+    }
+    int read(uint8_t *b, size_t n){
+      size_t k = (size_t)available() < n ? (size_t)available() : n;
+      memcpy(b, p->in.data() + p->inOff, k);
+      p->inOff += k;
+      return (int)k;
+    }
+    size_t write(const uint8_t *b, size_t n){
+      if (!p->open) return 0;
+      if (n > p->budget) n = p->budget;
+      if (p->budget != (size_t)-1) p->budget -= n;
+      p->out.append((const char*)b, n);
+      return n;
+    }
+    void stop(){ if (p) p->open = false; }
+  };
+
+  std::deque<std::shared_ptr<Pipe>> pending;
+  std::vector<std::shared_ptr<Pipe>> all;
+  uint32_t waits = 0;
+
+  std::shared_ptr<Pipe> connect(const std::string &req = ""){
+    auto p = std::make_shared<Pipe>();
+    p->in = req;
+    pending.push_back(p);
+    all.push_back(p);
+    return p;
+  }
+  Client accept(){
+    Client c;
+    if (!pending.empty()){ c.p = pending.front(); pending.pop_front(); }
+    return c;
+  }
+  void wait(){
+    waits++;
+    for (auto &p : all) p->budget += p->refill;
+  }
+};
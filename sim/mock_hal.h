@@ -0,0 +1,97 @@
+#pragma once
+/*
+ * HAL de mentira para compilar irrigation_core.h no host.
+ *
+ * Relógio virtual: millis() lê hal::nowUs e delay() só o avança, então o
+ * replay roda muito mais rápido que o tempo real mas o firmware "vê" o
+ * mesmo tempo que veria no ESP32 (incluindo os delay(2) do readAvg()).
+ * Entradas (ADC, DHT) vêm de hal::adc[] / hal::dhtTemp / hal::dhtHum;
+ * saídas digitais ficam em hal::level[] com contagem de transições.
+ */
+#include <stdint.h>
+#include <math.h>
+#include <map>
+#include <string>
+
+namespace hal {
+  const int NPINS = 256;                 // GPIO + canais de mux/expansor
+  inline uint64_t nowUs = 0;
+  inline int      adc[NPINS]      = {};
+  inline int      level[NPINS]    = {};
+  inline uint32_t toggles[NPINS]  = {};
+  inline float    dhtTemp = 25.0f, dhtHum = 50.0f;
+  inline uint32_t dhtReads = 0;
+  inline uint32_t DHT_READ_US = 5000;     // transação do DHT22 (aprox.)
+
+  inline void reset(){
+    nowUs = 0; dhtReads = 0;
+    for (int i = 0; i < NPINS; i++){ adc[i] = 0; level[i] = 0; toggles[i] = 0; }
+  }
+}
+
+/* ---------- Arduino core ---------- */
+const int LOW = 0, HIGH = 1, INPUT = 0, OUTPUT = 1;
+
+inline unsigned long millis(){ return (unsigned long)(hal::nowUs / 1000); }
+inline unsigned long micros(){ return (unsigned long)hal::nowUs; }
+inline void delay(uint32_t ms){ hal::nowUs += (uint64_t)ms * 1000; }
+inline void pinMode(int, int){}
+inline int  analogRead(int pin){ return hal::adc[pin]; }
+inline void digitalWrite(int pin, int v){
+  if (hal::level[pin] != v) hal::toggles[pin]++;
+  hal::level[pin] = v;
+}
+template <class T> inline T constrain(T x, T lo, T hi){ return x < lo ? lo : (x > hi ? hi : x); }
+
+/* ---------- FreeRTOS (single-thread no host) ---------- */
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define taskENTER_CRITICAL(m) ((void)(m))
+#define taskEXIT_CRITICAL(m)  ((void)(m))
+
+/* ---------- DHT ---------- */
+#define DHT22 22
+class DHT {
+public:
+  DHT(int, int){}
+  void  begin(){}
+  float readTemperature(){ return read(hal::dhtTemp); }
+  float readHumidity()   { return read(hal::dhtHum); }
+private:
+  float read(float v){ hal::dhtReads++; hal::nowUs += hal::DHT_READ_US / 2; return v; }
+};
+
+/* ---------- Preferences (NVS) ---------- */
+class Preferences {
+public:
+  static std::map<std::string, std::map<std::string, std::string>> &store(){
+    static std::map<std::string, std::map<std::string, std::string>> s; return s;
+  }
+  static uint32_t &commits(){ static uint32_t c = 0; return c; }   // gravações na flash
+
+  bool begin(const char *ns, bool readOnly = false){ ns_ = ns; ro_ = readOnly; return true; }
+  void end(){}
+  bool isKey(const char *k){ return ns().count(k) != 0; }
+  bool clear(){ if (ro_) return false; ns().clear(); commits()++; return true; }
+  bool remove(const char *k){ if (ro_) return false; commits()++; return ns().erase(k) != 0; }
+
+  size_t putInt(const char *k, int32_t v){ return putBytes(k, &v, sizeof(v)); }
+  int32_t getInt(const char *k, int32_t def = 0){
+    int32_t v; return getBytes(k, &v, sizeof(v)) == sizeof(v) ? v : def;
+  }
+  size_t putBytes(const char *k, const void *buf, size_t n){
+    if (ro_) return 0;
+    ns()[k] = std::string((const char*)buf, n); commits()++; return n;
+  }
+  size_t getBytesLength(const char *k){ return isKey(k) ? ns()[k].size() : 0; }
+  size_t getBytes(const char *k, void *buf, size_t n){
+    if (!isKey(k) || ns()[k].size() > n) return 0;
+    const std::string &v = ns()[k];
+    v.copy((char*)buf, v.size()); return v.size();
+  }
+
+private:
+  std::map<std::string, std::string> &ns(){ return store()[ns_]; }
+  std::string ns_;
+  bool ro_ = false;
+};
@@ -0,0 +1,57 @@
+#pragma once
+// Implementação fuzzy original do ESP32_FACULDADE.C (antes do sugeno.h),
+// mantida só como referência para teste de equivalência e benchmark.
+#include <stdint.h>
+
+namespace ref {
+
+inline uint8_t tri_mu(uint8_t x, uint8_t a, uint8_t b, uint8_t c){
+  if (x<=a || x>=c) return 0;
+  if (x==b) return 255;
+  if (x>b)  return (uint8_t)(((int)c - x) * 255 / ((int)c - b));
+  return (uint8_t)(((int)x - a) * 255 / ((int)b - a));
+}
+
+// Sem o teto PUMP_MAX_MS (aplicado por quem chama, igual ao sugeno.h)
+inline int ruleSugenoMs(uint8_t dry_low, uint8_t dry_med, uint8_t dry_high,
+                        uint8_t t_frio, uint8_t t_agrad, uint8_t t_quente,
+                        uint8_t l_escuro, uint8_t l_nublado, uint8_t l_sol,
+                        int &rule_id_out)
+{
+  (void)l_nublado;
+  const int R1=20000, R2=16000, R3=12000, R4=8000, R5=0, R6=0, R7=6000, R8=4000;
+  auto umin = [](uint8_t a,uint8_t b){ return a<b?a:b; };
+  auto umax = [](uint8_t a,uint8_t b){ return a>b?a:b; };
+  auto min3 = [&](uint8_t a,uint8_t b,uint8_t c){ return umin(a, umin(b,c)); };
+
+  uint8_t w1 = min3(dry_high, t_quente, l_sol);
+  uint8_t w2 = umin(dry_high, umax(t_quente, t_agrad));
+  uint8_t w3 = min3(dry_med, t_quente, l_sol);
+  uint8_t w4 = umin(dry_med, umax(t_quente, t_agrad));
+  uint8_t w5 = dry_low;
+  uint8_t w6 = umin(t_frio, l_escuro);
+  uint8_t w7 = umin(dry_high, l_escuro);
+  uint8_t w8 = umin(dry_med, l_escuro);
+
+  uint32_t num =
+    (uint32_t)w1*R1 + (uint32_t)w2*R2 + (uint32_t)w3*R3 + (uint32_t)w4*R4 +
+    (uint32_t)w5*R5 + (uint32_t)w6*R6 + (uint32_t)w7*R7 + (uint32_t)w8*R8;
+  uint32_t den = (uint32_t)w1 + w2 + w3 + w4 + w5 + w6 + w7 + w8;
+
+  uint8_t ws[8]={w1,w2,w3,w4,w5,w6,w7,w8};
+  uint8_t maxw=0; int rid=0;
+  for(int i=0;i<8;i++){ if(ws[i]>maxw){ maxw=ws[i]; rid=i+1; } }
+  rule_id_out = (maxw==0?0:rid);
+
+  if (den==0) return 0;
+  return (int)(num/den);
+}
+
+inline int decide(uint8_t dry, uint8_t t, uint8_t lz, int &rule_id_out){
+  return ruleSugenoMs(tri_mu(dry, 0,10,30), tri_mu(dry, 35,50,65), tri_mu(dry, 70,90,100),
+                      tri_mu(t, 0,10,15),   tri_mu(t, 18,23,28),   tri_mu(t, 28,35,45),
+                      tri_mu(lz, 0,5,15),   tri_mu(lz, 40,50,60),  tri_mu(lz, 70,85,100),
+                      rule_id_out);
+}
+
+} // namespace ref
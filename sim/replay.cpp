@@ -0,0 +1,170 @@
+/*
+ * Replay do laço de controle no host (relógio virtual), com relatório de
+ * desempenho: decisões/s, latência por decisão (RNF-02 < 1 s) e
+ * acionamentos da bomba.
+ *
+ *   build/replay                      7 dias sintéticos (planta em malha fechada)
+ *   build/replay --days 30 --seed 7
+ *   build/replay --trace hist.csv     CSV do /history (malha aberta)
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include "mock_hal.h"
+#include "irrigation_core.h"
+
+enum { P_SOIL = 34, P_LDR = 35, P_WATER = 39, P_PUMP = 26 };
+const uint32_t SAMPLE_PERIOD_MS = 500;   // igual ao sketch
+const double   RNF02_MS         = 1000;
+
+/* ---------------- entradas ---------------- */
+struct Inputs { int soilRaw, ldrRaw, waterRaw; float temp, hum; };
+
+// Planta sintética: o solo seca com calor/luz e molha com a bomba; o
+// reservatório esvazia com a bomba e é reabastecido a cada 3 dias.
+struct SyntheticPlant {
+  double soilPct = 75, waterPct = 100;
+  uint32_t rng;
+  explicit SyntheticPlant(uint32_t seed) : rng(seed) {}
+
+  double noise(){ rng = rng * 1664525u + 1013904223u; return ((rng >> 8) / 16777216.0) - 0.5; }
+
+  Inputs at(double tSec, bool pumpOn, double dtSec){
+    double day   = fmod(tSec, 86400) / 86400;
+    double sun   = fmax(0, sin((day - 0.25) * 2 * M_PI));            // 0 à noite
+    double temp  = 18 + 14 * sun + 2 * noise();
+    double dryK  = (0.8 + 2.5 * sun + 0.05 * (temp - 20)) / 3600;    // %/s
+    soilPct += (pumpOn ? 0.6 : 0) * dtSec - dryK * dtSec;
+    soilPct  = fmin(100, fmax(0, soilPct));
+    if (pumpOn) waterPct -= 0.02 * dtSec;
+    if (fmod(tSec, 3 * 86400) < dtSec) waterPct = 100;
+    waterPct = fmax(0, waterPct);
+
+    Inputs in;
+    in.soilRaw  = (int)(4095 - (4095 - 1200) * soilPct / 100 + 15 * noise());
+    in.ldrRaw   = (int)(381 + (737 - 381) * sun + 8 * noise());
+    in.waterRaw = (int)(300 + (2200 - 300) * waterPct / 100 + 20 * noise());
+    in.temp     = (float)temp;
+    in.hum      = (float)(70 - 30 * sun);
+    return in;
+  }
+};
+
+// Trace gravado (CSV do /history): ts,soil_raw,soil_pct,ldr_raw,ldr_pct,water_raw,water_pct,temp_c,humid,...
+static bool loadTrace(const char *path, std::vector<std::pair<double, Inputs>> &out){
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  char line[256];
+  while (fgets(line, sizeof(line), f)){
+    unsigned ts, sr, sp, lr, lp, wr, wp; float t = NAN, h = NAN;
+    char tbuf[16] = "", hbuf[16] = "";
+    if (sscanf(line, "%u,%u,%u,%u,%u,%u,%u,%15[^,],%15[^,]", &ts, &sr, &sp, &lr, &lp, &wr, &wp, tbuf, hbuf) < 7) continue;
+    if (*tbuf) t = strtof(tbuf, nullptr);
+    if (*hbuf) h = strtof(hbuf, nullptr);
+    out.push_back({ (double)ts, { (int)sr, (int)lr, (int)wr, t, h } });
+  }
+  fclose(f);
+  if (!out.empty()){ double t0 = out[0].first; for (auto &e : out) e.first -= t0; }
+  return !out.empty();
+}
+
+/* ---------------- estatística ---------------- */
+struct Stats {
+  std::vector<float> ns;
+  double sum = 0, max = 0;
+  void add(double v){ ns.push_back((float)v); sum += v; if (v > max) max = v; }
+  double pct(double p){
+    if (ns.empty()) return 0;
+    size_t k = (size_t)(p * (ns.size() - 1));
+    std::nth_element(ns.begin(), ns.begin() + k, ns.end());
+    return ns[k];
+  }
+};
+
+int main(int argc, char **argv){
+  double days = 7; uint32_t seed = 1; const char *trace = nullptr;
+  for (int i = 1; i < argc; i++){
+    if      (!strcmp(argv[i], "--days")  && i + 1 < argc) days  = atof(argv[++i]);
+    else if (!strcmp(argv[i], "--seed")  && i + 1 < argc) seed  = (uint32_t)atoi(argv[++i]);
+    else if (!strcmp(argv[i], "--trace") && i + 1 < argc) trace = argv[++i];
+    else { fprintf(stderr, "uso: %s [--days N] [--seed S] [--trace hist.csv]\n", argv[0]); return 2; }
+  }
+
+  std::vector<std::pair<double, Inputs>> rec;
+  if (trace){
+    if (!loadTrace(trace, rec)){ fprintf(stderr, "trace vazio/inválido: %s\n", trace); return 1; }
+    days = rec.back().first / 86400;
+  }
+
+  hal::reset();
+  DHT dht(22, DHT22);
+  IrrigationCore core({ P_LDR, P_WATER }, dht);
+  core.addZone({ P_SOIL, P_PUMP });
+  core.begin();
+  SyntheticPlant plant(seed);
+
+  Stats wallNs, virtMs;
+  uint64_t decisions = 0, pumpStarts = 0, pumpOnMs = 0, lowWater = 0;
+  bool lastPump = false;
+  double minSoil = 100;
+  size_t ri = 0;
+  const uint64_t endUs = (uint64_t)(days * 86400e6);
+  ZoneSnapshot snap = {};
+  const Telemetry &s = snap.z[0];
+
+  auto wall0 = std::chrono::steady_clock::now();
+  uint64_t nextUs = 0;
+  while (hal::nowUs < endUs){
+    double tSec = hal::nowUs / 1e6;
+    Inputs in;
+    if (trace){
+      while (ri + 1 < rec.size() && rec[ri + 1].first <= tSec) ri++;
+      in = rec[ri].second;
+    } else {
+      in = plant.at(tSec, core.pumpOn(), SAMPLE_PERIOD_MS / 1000.0);
+      minSoil = fmin(minSoil, plant.soilPct);
+    }
+    hal::adc[P_SOIL] = in.soilRaw; hal::adc[P_LDR] = in.ldrRaw; hal::adc[P_WATER] = in.waterRaw;
+    hal::dhtTemp = in.temp; hal::dhtHum = in.hum;
+
+    uint64_t v0 = hal::nowUs;
+    auto w0 = std::chrono::steady_clock::now();
+    snap.z[0].seq++;
+    core.sample(snap);
+    auto w1 = std::chrono::steady_clock::now();
+    double wns = std::chrono::duration<double, std::nano>(w1 - w0).count();
+    wallNs.add(wns);
+    virtMs.add((hal::nowUs - v0) / 1000.0);   // ADC + DHT no tempo do dispositivo
+    decisions++;
+
+    if (s.pumpOn && !lastPump) pumpStarts++;
+    if (s.pumpOn) pumpOnMs += SAMPLE_PERIOD_MS;
+    if (s.waterPct < core.params().waterMinPct) lowWater++;
+    lastPump = s.pumpOn;
+
+    nextUs += SAMPLE_PERIOD_MS * 1000ULL;      // vTaskDelayUntil
+    if (hal::nowUs < nextUs) hal::nowUs = nextUs;
+    core.watchdog();
+  }
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall0).count();
+
+  double worstMs = virtMs.max + wallNs.max / 1e6;
+  printf("replay: %s, %.2f dias simulados (%llu decisões a cada %u ms)\n",
+         trace ? trace : "planta sintética", days, (unsigned long long)decisions, SAMPLE_PERIOD_MS);
+  printf("  tempo de parede        : %.3f s (%.0fx tempo real)\n", wallS, days * 86400 / wallS);
+  printf("  decisões/s (host)      : %.0f\n", decisions / wallS);
+  printf("  latência cálculo (host): média %.0f ns  p99 %.0f ns  máx %.0f ns\n",
+         wallNs.sum / decisions, wallNs.pct(0.99), wallNs.max);
+  printf("  aquisição (virtual)    : média %.1f ms  máx %.1f ms\n", virtMs.sum / decisions, virtMs.max);
+  printf("  pior decisão           : %.1f ms  -> RNF-02 (< %.0f ms): %s\n",
+         worstMs, RNF02_MS, worstMs < RNF02_MS ? "OK" : "VIOLADO");
+  printf("  bomba                  : %llu acionamentos (%.1f/dia), %.1f min ligada, %u transições no pino\n",
+         (unsigned long long)pumpStarts, pumpStarts / days, pumpOnMs / 60000.0, hal::toggles[P_PUMP]);
+  printf("  água < mínimo          : %.1f%% das decisões\n", 100.0 * lowWater / decisions);
+  if (!trace) printf("  solo mínimo (planta)   : %.1f%%\n", minSoil);
+  return worstMs < RNF02_MS ? 0 : 1;
+}
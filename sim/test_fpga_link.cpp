@@ -0,0 +1,129 @@
+// fpga_link.h contra o modelo do FPGA: quadro em rajada, decodificação das
+// saídas, watchdog do guard, falha de água, timeout + backoff e o fallback
+// do IrrigationCore para o Sugeno local (inclusive com o guard desligado).
+#include <stdio.h>
+#include "mock_hal.h"
+#include "fpga_model.h"
+#include "fpga_link.h"
+#include "irrigation_core.h"
+
+static int fails = 0;
+#define CHECK(c) do { if (!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); fails++; } } while (0)
+
+typedef FpgaLink<FpgaModel> Link;
+
+// troca completa no relógio virtual (o sketch cede a CPU com vTaskDelay)
+static bool exchange(Link &link, const FpgaInputs &in){
+  if (!link.start(in, micros())) return false;
+  while (!link.poll(micros())) hal::nowUs += 20;
+  return link.ok();
+}
+
+static int localMs(uint8_t soil, uint8_t t, uint8_t lz){
+  int rid;
+  return ruleSugenoMs((uint8_t)(100 - soil), t, lz, rid, 20000);
+}
+
+int main(){
+  hal::reset();
+  FpgaModel fpga;
+  Link link(fpga);
+
+  // 1ª troca: guard ainda não passou por um tick -> bomba desligada, sem falha
+  FpgaInputs in = { 20, 30, 90, 80 };
+  CHECK(exchange(link, in));
+  CHECK(fpga.bytesIn() == Link::FRAME_LEN && fpga.bytesOut() == Link::NREADS);
+  CHECK(fpga.soil() == 20 && fpga.water() == 80);
+  CHECK(!link.result().pumpOn && link.result().pumpMs == 0);
+  CHECK(link.result().status & fpga::ST_SOIL_LOW);
+
+  // RTT ~ 30 bytes no fio + última resposta + timeout de RX (2 símbolos)
+  double byteUs = 10e6 / fpga.baud;
+  CHECK(link.rttLastUs() >= 31 * byteUs && link.rttLastUs() <= 34 * byteUs);
+
+  // após o tick de 1 Hz o guard liga e pump_ms = Sugeno do FPGA (= local)
+  delay(1000);
+  CHECK(exchange(link, in));
+  CHECK(link.result().pumpOn && (link.result().status & fpga::ST_ON));
+  CHECK(link.result().pumpMs == localMs(20, 30, 90));
+  CHECK(link.result().pumpMs > 0);
+
+  // watchdog: WD_TIMEOUT_S + 2 ticks (contador e wd_ok registrados) sem
+  // troca -> FAULT_WD (o próprio quadro chuta, mas só conta no próximo
+  // tick) e o resultado é descartado
+  delay(8000);
+  CHECK(!exchange(link, in));
+  CHECK(link.state() == Link::DONE && (link.result().fault & fpga::FAULT_WD));
+  CHECK(!link.result().pumpOn);
+  delay(1000);
+  CHECK(!exchange(link, in));                       // wd_ok volta um tick depois
+  delay(1000);
+  CHECK(exchange(link, in));
+  CHECK(link.faults() == 2);
+
+  // reservatório abaixo do WATER_MIN do guard
+  in.waterPct = 2;
+  CHECK(!exchange(link, in) && (link.result().fault & fpga::FAULT_WATER));
+  in.waterPct = 80;
+  CHECK(exchange(link, in));
+
+  // FPGA mudo: timeout, e após FAIL_LIMIT seguidos só tenta a cada BACKOFF_US
+  fpga.mute = true;
+  uint32_t to0 = link.timeouts();
+  for (int i = 0; i < Link::FAIL_LIMIT; i++){ CHECK(!exchange(link, in)); delay(500); }
+  CHECK(link.timeouts() - to0 == Link::FAIL_LIMIT);
+  CHECK(link.state() == Link::TIMEOUT);
+  CHECK(!link.start(in, micros()));                 // backoff
+  fpga.mute = false;
+  delay(Link::BACKOFF_US / 1000);
+  CHECK(!exchange(link, in));                       // responde, mas o watchdog
+  CHECK(link.state() == Link::DONE);                // venceu durante a queda
+  CHECK(link.result().fault & fpga::FAULT_WD);
+
+  // integração: zona 0 usa o FPGA; sem resposta volta ao Sugeno local
+  hal::reset();
+  FpgaModel fpga2;
+  Link link2(fpga2);
+  DHT dht(22, DHT22);
+  IrrigationCore core({ 35, 39 }, dht);
+  core.addZone({ 34, 26 });
+  core.begin();
+  core.setSugeno([](void *ctx, uint8_t zone, uint8_t soil, uint8_t t, uint8_t lz, uint8_t water, int &ms){
+    Link &l = *(Link*)ctx;
+    if (zone != 0 || !exchange(l, { soil, t, lz, water }) || !l.hasMs()) return false;
+    ms = l.result().pumpMs;
+    return true;
+  }, &link2);
+
+  ZoneSnapshot snap = {};
+  int soil[1] = { 4095 - (4095 - 1200) * 20 / 100 };   // ~19 %
+  core.decide(soil, 737, 2200, false, snap);
+  CHECK(core.sugenoExtHits() == 0);                  // guard ainda desligado: pump_ms = 0
+  CHECK(snap.z[0].pumpMsSug == localMs(snap.z[0].soilPct, 25, 100));   // não é demanda
+  CHECK(snap.z[0].pumpMsSug > 0);
+  delay(1000);
+  core.decide(soil, 737, 2200, false, snap);
+  CHECK(core.sugenoExtHits() == 1);
+  CHECK(snap.z[0].pumpMsSug == localMs(snap.z[0].soilPct, 25, 100));
+  CHECK(snap.z[0].pumpMsSug > 0);
+
+  // solo entre os 40 % do guard e os 65 % da histerese local: o guard
+  // desliga e zera pump_ms, a demanda continua vindo do Sugeno local
+  int mid[1] = { 4095 - (4095 - 1200) * 50 / 100 };
+  core.decide(mid, 737, 2200, false, snap);
+  delay(1000);
+  uint32_t hits = core.sugenoExtHits();
+  core.decide(mid, 737, 2200, false, snap);
+  CHECK(!link2.result().pumpMs && !(link2.result().status & fpga::ST_ON));
+  CHECK(core.sugenoExtHits() == hits);
+  CHECK(snap.z[0].pumpMsSug == localMs(snap.z[0].soilPct, 25, 100) && snap.z[0].pumpMsSug > 0);
+
+  fpga2.mute = true;
+  delay(500);
+  core.decide(soil, 737, 2200, false, snap);
+  CHECK(core.sugenoExtHits() == hits);               // fallback
+  CHECK(snap.z[0].pumpMsSug == localMs(snap.z[0].soilPct, 25, 100));
+
+  printf("test_fpga_link: %s\n", fails ? "FAIL" : "OK");
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,361 @@
+// http_server.h sobre um transporte em memória: keep-alive, pipeline,
+// requisição chegando byte a byte, formulário POST, escrita parcial sem
+// travar as outras conexões, limites (404/405/413/431, Content-Length
+// inválido), ociosidade, rodízio dos slots, chunked (inclusive gerado aos
+// pedaços para cliente lento), detach (SSE) e a
+// página do "/" pré-comprimida (gunzip == web/index.html).
+#include <stdio.h>
+#include <zlib.h>
+#include "http_server.h"
+#include "mem_net.h"
+#include "index_html.h"
+
+static int fails = 0;
+#define CHECK(c) do { if (!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); fails++; } } while (0)
+
+typedef http::Server<MemNet, 4> Srv;
+static MemNet net;
+static Srv *srv;
+
+// Respostas completas em out (pelo Content-Length ou pelo fim do chunked)
+struct Resp { int code; std::string head, body; };
+static std::vector<Resp> parse(const std::string &out){
+  std::vector<Resp> v;
+  size_t pos = 0;
+  while (pos < out.size()){
+    size_t e = out.find("\r\n\r\n", pos);
+    if (e == std::string::npos) break;
+    Resp r;
+    r.head = out.substr(pos, e + 4 - pos);
+    r.code = atoi(r.head.c_str() + 9);
+    pos = e + 4;
+    size_t cl = r.head.find("Content-Length: ");
+    if (cl != std::string::npos){
+      size_t n = strtoul(r.head.c_str() + cl + 16, nullptr, 10);
+      if (pos + n > out.size()) break;
+      r.body = out.substr(pos, n);
+      pos += n;
+    } else {
+      for (;;){
+        size_t le = out.find("\r\n", pos);
+        if (le == std::string::npos) return v;
+        size_t n = strtoul(out.c_str() + pos, nullptr, 16);
+        pos = le + 2;
+        if (!n){ pos += 2; break; }
+        r.body += out.substr(pos, n);
+        pos += n + 2;
+      }
+    }
+    v.push_back(r);
+  }
+  return v;
+}
+
+static std::string get(const char *path, const char *extra = ""){
+  return std::string("GET ") + path + " HTTP/1.1\r\nHost: esp\r\n" + extra + "\r\n";
+}
+
+static void pump(uint32_t now, int n = 8){ for (int i = 0; i < n; i++) srv->poll(now); }
+
+/* ---------------- rotas de teste ---------------- */
+static int dataCalls = 0;
+static void handleData(){
+  dataCalls++;
+  char b[64];
+  snprintf(b, sizeof(b), "{\"zone\":%d,\"n\":%d}", atoi(srv->arg("zone")), dataCalls);
+  srv->sendHeader("Access-Control-Allow-Origin", "*");
+  srv->send(200, "application/json", b);
+}
+
+static void handleIndex(){
+  srv->sendHeader("ETag", INDEX_HTML_ETAG);
+  srv->sendHeader("Vary", "Accept-Encoding");
+  if (!strcmp(srv->header("If-None-Match"), INDEX_HTML_ETAG)){ srv->send(304); return; }
+  if (srv->acceptsGzip()){
+    srv->sendHeader("Content-Encoding", "gzip");
+    srv->sendStatic(200, "text/html; charset=utf-8", INDEX_HTML_GZ, sizeof(INDEX_HTML_GZ));
+  } else srv->sendStatic(200, "text/html; charset=utf-8", INDEX_HTML, sizeof(INDEX_HTML));
+}
+
+static std::string formSeen;
+static void handleForm(){
+  formSeen = std::string(srv->arg("name")) + "|" + srv->arg("mf") + "|" + (srv->hasArg("use") ? "use" : "-");
+  srv->send(200, "text/plain", "OK");
+}
+
+static void handleBig(){
+  static char big[3000];
+  memset(big, 'x', sizeof(big));
+  srv->send(200, "text/plain", big, sizeof(big));             // maior que o buffer da conexão
+}
+
+static void handleCsv(){
+  srv->beginChunked(200, "text/csv");
+  srv->sendChunk("a,b\n", 4);
+  srv->sendChunk("1,2\n", 4);
+  srv->endChunked();
+}
+
+// Corpo gerado aos pedaços: linhas "i,i*i" até n, com o cursor na conexão
+struct Rows { int i, n; };
+static int rowCalls = 0;
+static size_t rowsChunk(void *state, char *buf, size_t cap){
+  Rows &q = *(Rows*)state;
+  rowCalls++;
+  size_t len = 0;
+  for (; q.i < q.n && len + 24 <= cap; q.i++) len += snprintf(buf + len, cap - len, "%d,%d\n", q.i, q.i * q.i);
+  return len;
+}
+static std::string rowsText(int n){
+  std::string t;
+  char b[24];
+  for (int i = 0; i < n; i++){ snprintf(b, sizeof(b), "%d,%d\n", i, i * i); t += b; }
+  return t;
+}
+static void handleRows(){
+  Rows q = { 0, atoi(srv->arg("n")) };
+  srv->sendChunked(200, "text/csv", rowsChunk, &q, sizeof(q));
+}
+
+static MemNet::Client detached;
+static void handleStream(){ detached = srv->detach(); }
+
+static void routes(Srv &s){
+  s.on("/",       http::GET,  handleIndex);
+  s.on("/data",   http::GET,  handleData);
+  s.on("/form",   http::POST, handleForm);
+  s.on("/big",    http::GET,  handleBig);
+  s.on("/csv",    http::GET,  handleCsv);
+  s.on("/rows",   http::GET,  handleRows);
+  s.on("/stream", http::GET,  handleStream);
+}
+
+/* ---------------- casos ---------------- */
+static void keepAliveAndPipeline(){
+  Srv s(net); srv = &s; routes(s);
+  auto p = net.connect(get("/data?zone=1"));
+  pump(0);
+  auto r = parse(p->out);
+  CHECK(r.size() == 1 && r[0].code == 200 && r[0].body == "{\"zone\":1,\"n\":1}");
+  CHECK(r[0].head.find("Connection: keep-alive") != std::string::npos);
+  CHECK(r[0].head.find("Access-Control-Allow-Origin: *\r\n") != std::string::npos);
+  CHECK(p->open && s.active() == 1);
+
+  // mesma conexão, duas requisições num só segmento (pipeline)
+  p->in += get("/data?zone=2") + get("/data?zone=3", "Connection: close\r\n");
+  pump(0);
+  r = parse(p->out);
+  CHECK(r.size() == 3 && r[1].body == "{\"zone\":2,\"n\":2}" && r[2].body == "{\"zone\":3,\"n\":3}");
+  CHECK(r[2].head.find("Connection: close") != std::string::npos);
+  CHECK(!p->open && s.active() == 0 && s.accepted() == 1 && s.requests() == 3);
+
+  // HTTP/1.0 sem keep-alive fecha
+  auto q = net.connect("GET /data HTTP/1.0\r\n\r\n");
+  pump(0);
+  CHECK(parse(q->out).size() == 1 && !q->open);
+}
+
+static void byteAtATime(){
+  Srv s(net); srv = &s; routes(s);
+  std::string body = "name=tom%20ate&mf=30%2C50%2C70&use";
+  char req[256];
+  snprintf(req, sizeof(req), "POST /form HTTP/1.1\r\nContent-Type: application/x-www-form-urlencoded\r\n"
+                             "Content-Length: %zu\r\n\r\n%s", body.size(), body.c_str());
+  auto p = net.connect(std::string(req) + get("/data"));
+  p->drip = 1;
+  size_t len = strlen(req);
+  for (size_t i = 0; i + 1 < len; i++) s.poll(0);
+  CHECK(p->out.empty());                                       // falta 1 byte do corpo
+  pump(0, 2);
+  CHECK(formSeen == "tom ate|30,50,70|use");
+  pump(0, 64);
+  auto r = parse(p->out);
+  CHECK(r.size() == 2 && r[0].body == "OK" && r[1].code == 200);
+}
+
+static void slowClient(){
+  Srv s(net); srv = &s; routes(s);
+  auto slow = net.connect(get("/big"));
+  slow->budget = slow->refill = 100;
+  auto fast = net.connect(get("/data"));
+  net.waits = 0;
+  // corpo maior que o buffer vai na escrita bloqueante (cede com wait())
+  pump(0, 1);
+  auto rs = parse(slow->out);
+  CHECK(rs.size() == 1 && rs[0].body.size() == 3000 && net.waits >= 29);
+  CHECK(parse(fast->out).size() == 1);
+
+  // resposta que cabe no buffer: escrita aos poucos, sem segurar as outras
+  Srv s2(net); srv = &s2; routes(s2);
+  auto a = net.connect(get("/"));
+  a->budget = 16;
+  auto b = net.connect(get("/data"));
+  s2.poll(0);
+  CHECK(a->out.size() == 16 && parse(b->out).size() == 1);
+  for (int i = 0; i < 200 && parse(a->out).empty(); i++){ a->budget = 16; s2.poll(0); }
+  auto r = parse(a->out);
+  CHECK(r.size() == 1 && r[0].code == 200);
+}
+
+static void limits(){
+  Srv s(net); srv = &s; routes(s);
+  auto nf = net.connect(get("/nada"));
+  auto na = net.connect("POST /data HTTP/1.1\r\nContent-Length: 0\r\n\r\n");
+  auto big = net.connect("POST /form HTTP/1.1\r\nContent-Length: 5000\r\n\r\n");
+  auto hdr = net.connect("GET / HTTP/1.1\r\nX-Pad: " + std::string(2000, 'a'));
+  pump(0);
+  CHECK(parse(nf->out).size() == 1 && parse(nf->out)[0].code == 404 && nf->open);
+  CHECK(parse(na->out)[0].code == 405);
+  CHECK(parse(big->out)[0].code == 413 && !big->open);
+  CHECK(parse(hdr->out)[0].code == 431 && !hdr->open);
+
+  // Content-Length enorme não dá a volta na conta de tamanho; lixo é 400.
+  // Em nenhum caso o handler roda nem sobra cabeçalho virando "requisição".
+  formSeen.clear();
+  auto huge = net.connect("POST /form HTTP/1.1\r\nContent-Length: 18446744073709551615\r\n\r\nname=x");
+  auto wrap = net.connect("POST /form HTTP/1.1\r\nContent-Length: 18446744073709551600\r\nX-A: 1\r\n\r\n");
+  auto junk = net.connect("POST /form HTTP/1.1\r\nContent-Length: 12abc\r\n\r\nname=x");
+  auto neg  = net.connect("POST /form HTTP/1.1\r\nContent-Length: -1\r\n\r\nname=x");
+  pump(0);
+  for (auto &c : { huge, wrap }){ auto r = parse(c->out); CHECK(r.size() == 1 && r[0].code == 413 && !c->open); }
+  for (auto &c : { junk, neg }){ auto r = parse(c->out); CHECK(r.size() == 1 && r[0].code == 400 && !c->open); }
+  CHECK(formSeen.empty());
+
+  // ociosidade: conexão aberta sem requisição é encerrada
+  auto idle = net.connect();
+  s.poll(1000);
+  CHECK(idle->open);
+  s.poll(1000 + Srv::IDLE_MS + 1);
+  CHECK(!idle->open && !nf->open);
+
+  // mais clientes que slots: o excedente espera na fila e entra no rodízio
+  Srv s2(net); srv = &s2; routes(s2);
+  std::shared_ptr<Pipe> c[6];
+  for (auto &p : c) p = net.connect(get("/data"));
+  s2.poll(0);
+  CHECK(s2.accepted() == 4 && net.pending.size() == 2);
+  for (int i = 0; i < 4; i++) c[i]->in += get("/data", "Connection: close\r\n");
+  pump(0);
+  CHECK(s2.accepted() == 6);
+  for (int i = 4; i < 6; i++) CHECK(parse(c[i]->out).size() == 1);
+
+  // teto de requisições por conexão
+  Srv s3(net); srv = &s3; routes(s3);
+  std::string many;
+  for (int i = 0; i < Srv::KEEPALIVE_MAX + 2; i++) many += get("/data");
+  auto k = net.connect(many);
+  pump(0, 200);
+  auto r = parse(k->out);
+  CHECK(r.size() == Srv::KEEPALIVE_MAX && !k->open);
+  CHECK(r.back().head.find("Connection: close") != std::string::npos);
+}
+
+static void chunkedAndDetach(){
+  Srv s(net); srv = &s; routes(s);
+  auto p = net.connect(get("/csv") + get("/stream"));
+  pump(0);
+  auto r = parse(p->out);
+  CHECK(r.size() == 1 && r[0].body == "a,b\n1,2\n");
+  CHECK(r[0].head.find("Transfer-Encoding: chunked") != std::string::npos);
+  CHECK(detached && detached.p == p && p->open && s.active() == 0);   // socket com o handler
+  detached.stop();
+}
+
+// Cliente lento num chunked: o gerador só anda quando a parte anterior saiu,
+// nenhum poll() espera pela rede e as outras conexões seguem atendidas
+static void chunkedSlowClient(){
+  Srv s(net); srv = &s; routes(s);
+  auto slow = net.connect(get("/rows?n=2000") + get("/data"));
+  slow->budget = 256;                                      // cabeçalho + começo da 1ª parte
+  net.waits = 0; rowCalls = 0;
+  s.poll(0);
+  CHECK(slow->out.size() < 256 && rowCalls == 0);          // handler só manda o cabeçalho
+  for (int i = 0; i < 5; i++) s.poll(0);
+  CHECK(slow->out.size() == 256 && rowCalls == 1);          // 1ª parte presa: nada mais gerado
+  auto fast = net.connect(get("/data"));
+  s.poll(0);
+  CHECK(parse(fast->out).size() == 1);
+
+  for (int i = 0; i < 5000 && parse(slow->out).size() < 2; i++){ slow->budget = 64; s.poll(i); }
+  auto r = parse(slow->out);
+  CHECK(r.size() == 2 && r[0].code == 200 && r[0].body == rowsText(2000) && r[1].code == 200);
+  CHECK(r[0].head.find("Transfer-Encoding: chunked") != std::string::npos);
+  CHECK(net.waits == 0 && slow->open);                     // keep-alive depois do terminador
+
+  // cliente que parou de ler: o slot sai por ociosidade, sem travar o poll()
+  auto stuck = net.connect(get("/rows?n=2000"));
+  stuck->budget = 0;
+  s.poll(10000);
+  s.poll(10000 + Srv::IDLE_MS + 1);
+  CHECK(!stuck->open && net.waits == 0);
+
+  // chunked escrito direto (beginChunked): cliente parado é abandonado na
+  // primeira vez que as esperas acabam, não a cada sendChunk
+  auto dead = net.connect(get("/csv"));
+  dead->budget = 0;
+  auto other = net.connect(get("/data"));
+  s.poll(20000);
+  CHECK(!dead->open && net.waits == Srv::WRITE_SPINS);
+  CHECK(parse(other->out).size() == 1);
+}
+
+static std::string gunzip(const uint8_t *gz, size_t n){
+  z_stream z = {};
+  inflateInit2(&z, 16 + MAX_WBITS);
+  std::string out(64 * 1024, 0);
+  z.next_in = (Bytef*)gz;  z.avail_in = n;
+  z.next_out = (Bytef*)&out[0];  z.avail_out = out.size();
+  int rc = inflate(&z, Z_FINISH);
+  out.resize(rc == Z_STREAM_END ? z.total_out : 0);
+  inflateEnd(&z);
+  return out;
+}
+
+static void indexPage(){
+  Srv s(net); srv = &s; routes(s);
+  auto gz  = net.connect(get("/", "Accept-Encoding: gzip, deflate\r\n"));
+  auto raw = net.connect(get("/"));
+  auto nm  = net.connect(get("/", (std::string("If-None-Match: ") + INDEX_HTML_ETAG + "\r\n").c_str()));
+  pump(0);
+  auto rg = parse(gz->out), rr = parse(raw->out), rn = parse(nm->out);
+  CHECK(rg.size() == 1 && rg[0].head.find("Content-Encoding: gzip") != std::string::npos);
+  CHECK(rg[0].head.find("Vary: Accept-Encoding") != std::string::npos);
+  CHECK(rr.size() == 1 && rr[0].head.find("Content-Encoding") == std::string::npos);
+  CHECK(rn.size() == 1 && rn[0].code == 304 && rn[0].body.empty());
+  CHECK(sizeof(INDEX_HTML_GZ) < sizeof(INDEX_HTML));
+
+  std::string html((const char*)INDEX_HTML, sizeof(INDEX_HTML));
+  CHECK(rr[0].body == html);
+  CHECK(gunzip((const uint8_t*)rg[0].body.data(), rg[0].body.size()) == html);
+
+  // index_html.h em dia com web/index.html
+  FILE *f = fopen("../web/index.html", "rb");
+  CHECK(f);
+  if (f){
+    std::string src;
+    char b[512];
+    size_t n;
+    while ((n = fread(b, 1, sizeof(b), f)) > 0) src.append(b, n);
+    fclose(f);
+    CHECK(src == html);
+  }
+
+  // corpo cacheado: válido só para a mesma (chave, versão, tag)
+  http::CachedBody<64> c;
+  CHECK(!c.fresh(0, 0, 0));
+  c.len = (size_t)snprintf(c.buf, sizeof(c.buf), "x");
+  c.store(1, 7, 0xabc, c.len);
+  CHECK(c.fresh(1, 7, 0xabc) && !c.fresh(1, 8, 0xabc) && !c.fresh(1, 7, 0xabd) && !c.fresh(0, 7, 0xabc));
+}
+
+int main(){
+  keepAliveAndPipeline();
+  byteAtATime();
+  slowClient();
+  limits();
+  chunkedAndDetach();
+  chunkedSlowClient();
+  indexPage();
+  printf("test_http: %s\n", fails ? "FAIL" : "OK");
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,187 @@
+// irrigation_core.h sobre o HAL de mentira: histerese, fail-safe de água,
+// watchdog do /pump, cache do DHT, persistência da calibração e o
+// agendador multi-zona (limite de bombas, prioridade por demanda, aging).
+#include <stdio.h>
+#include "mock_hal.h"
+#include "irrigation_core.h"
+
+static int fails = 0;
+#define CHECK(c) do { if (!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); fails++; } } while (0)
+
+enum { P_SOIL = 34, P_LDR = 35, P_WATER = 39, P_PUMP = 26 };
+
+// raw do solo para uma umidade % com a calibração padrão (4095 seco, 1200 molhado);
+// mapPctSmart() trunca, então soilRawFor(p) lê como p-1 %
+static int soilRawFor(int pct){ return 4095 - (4095 - 1200) * pct / 100; }
+
+static int onCount(const ZoneSnapshot &s){
+  int n = 0;
+  for (uint8_t i = 0; i < s.n; i++) n += s.z[i].pumpOn;
+  return n;
+}
+
+static void singleZone(){
+  hal::reset();
+  DHT dht(22, DHT22);
+  IrrigationCore core({ P_LDR, P_WATER }, dht);
+  CHECK(core.addZone({ P_SOIL, P_PUMP }) == 0);
+  core.begin();
+  CHECK(hal::level[P_PUMP] == HIGH);                 // relé ativo-baixo: desligado
+
+  ZoneSnapshot snap = {};
+  const Telemetry &s = snap.z[0];
+  int soil[1];
+  auto decide = [&](int pct, int water, bool dhtOk){
+    soil[0] = soilRawFor(pct);
+    core.decide(soil, 600, water, dhtOk, snap);
+  };
+  for (int i = 0; i < 30; i++) decide(80, 2200, false);  // assenta a EMA
+  CHECK(snap.n == 1);
+  CHECK(s.waterPct == 99 || s.waterPct == 100);
+  CHECK(!s.pumpOn);
+
+  // histerese: liga em <=65%, continua ligada entre 65 e 70, desliga em >=70%
+  decide(65, 2200, false);  CHECK(s.pumpOn);
+  CHECK(hal::level[P_PUMP] == LOW);
+  decide(68, 2200, false);  CHECK(s.pumpOn);
+  decide(71, 2200, false);  CHECK(!s.pumpOn);
+  decide(67, 2200, false);  CHECK(!s.pumpOn);
+
+  // rodada vencida com a zona ainda seca é reagendada sem pulso no relé
+  decide(60, 2200, false);  CHECK(s.pumpOn);
+  uint32_t toggles0 = hal::toggles[P_PUMP];
+  delay(core.params().minRunMs + 1);
+  decide(60, 2200, false);  CHECK(s.pumpOn);
+  CHECK(hal::toggles[P_PUMP] == toggles0);
+  decide(71, 2200, false);  CHECK(!s.pumpOn);
+
+  // loop() chama o watchdog entre as amostras: rodada agendada que vence com
+  // a zona seca continua ligada (1 acionamento em 60 s, nenhum corte)
+  decide(60, 2200, false);  CHECK(s.pumpOn);
+  toggles0 = hal::toggles[P_PUMP];
+  for (int k = 0; k < 120; k++){
+    for (int w = 0; w < 5; w++){ delay(100); core.watchdog(); CHECK(core.pumpOn()); }
+    decide(60, 2200, false);  CHECK(s.pumpOn);
+  }
+  CHECK(hal::toggles[P_PUMP] == toggles0);
+  // sem decide() (task parada) o watchdog corta após o prazo + pumpMaxMs
+  delay(core.params().pumpMaxMs);
+  core.watchdog();  CHECK(core.pumpOn());
+  delay(core.params().pumpMaxMs);
+  core.watchdog();  CHECK(!core.pumpOn() && hal::level[P_PUMP] == HIGH);
+  decide(71, 2200, false);  CHECK(!s.pumpOn);
+
+  // fail-safe: reservatório abaixo do mínimo impede e corta a bomba
+  for (int i = 0; i < 40; i++) decide(40, 300, false);
+  CHECK(s.waterPct < core.params().waterMinPct);
+  CHECK(!s.pumpOn);
+
+  // /pump?on=1&ms=3000: watchdog desliga após 3 s
+  CHECK(core.manualPump(0, true, 3000));
+  CHECK(core.pumpOn() && hal::level[P_PUMP] == LOW);
+  delay(2999); core.watchdog(); CHECK(core.pumpOn());
+  delay(2);    core.watchdog(); CHECK(!core.pumpOn() && hal::level[P_PUMP] == HIGH);
+
+  // teto de segurança no tempo manual
+  core.manualPump(0, true, 999999);
+  delay(core.params().pumpMaxMs + 1); core.watchdog(); CHECK(!core.pumpOn());
+  CHECK(!core.manualPump(1, true, 1000));           // zona inexistente
+
+  // DHT: no máximo uma transação a cada 2 s, com cache entre elas
+  hal::dhtTemp = 31.0f; hal::dhtHum = 40.0f;
+  uint32_t reads0 = hal::dhtReads;
+  for (int i = 0; i < 8; i++){ core.sample(snap); delay(500 - 112); }
+  CHECK(s.dhtOk && s.tempC == 31.0f);
+  CHECK(hal::dhtReads - reads0 <= 2 * 2);
+
+  // Sugeno chega ao snapshot (solo seco, quente, sol -> R1 domina)
+  soil[0] = soilRawFor(5);
+  core.decide(soil, 737, 2200, true, snap);
+  CHECK(s.ruleId == 1 || s.ruleId == 2);
+  CHECK(s.pumpMsSug > 12000 && s.pumpMsSug <= core.params().pumpMaxMs);
+
+  // calibração em NVS
+  Preferences prefs;
+  core.z.soilDry[0] = 3900;
+  core.saveConfig(prefs, "calib");
+  core.z.soilDry[0] = 1;
+  CHECK(!core.loadConfig(prefs, "calib") && core.z.soilDry[0] == 3900);
+  CHECK(core.zoneCal(0).soilDry == 3900);
+  core.resetConfig(prefs, "calib");
+  CHECK(!strcmp(core.loadConfig(prefs, "calib"), "NO_DATA"));
+}
+
+static void multiZone(){
+  hal::reset();
+  DHT dht(22, DHT22);
+  IrrigationCore core({ P_LDR, P_WATER }, dht);
+  const int NZ = 4;
+  for (int i = 0; i < NZ; i++) CHECK(core.addZone({ 12 + i, 28 + i }) == i);
+  profile::Profile pr = core.profile();
+  pr.par.maxPumps = 2;
+  CHECK(!core.putProfile(pr));
+  core.begin();
+
+  ZoneSnapshot snap = {};
+  int soil[NZ];
+  auto decide = [&](int water){ core.decide(soil, 737, water, false, snap); };
+  for (int i = 0; i < NZ; i++) soil[i] = soilRawFor(80);
+  for (int i = 0; i < 30; i++) decide(2200);
+  CHECK(snap.n == NZ && onCount(snap) == 0);
+
+  // todas secas, demandas diferentes: só maxPumps ligam, as de maior demanda
+  // (sem DHT válido a temperatura é 25 °C; luz 100%)
+  soil[0] = soilRawFor(60); soil[1] = soilRawFor(5);
+  soil[2] = soilRawFor(40); soil[3] = soilRawFor(20);
+  decide(2200);
+  CHECK(onCount(snap) == 2 && core.running() == 2);
+  CHECK(snap.z[0].pumpMsSug <= snap.z[2].pumpMsSug);
+  CHECK(snap.z[1].pumpOn && snap.z[3].pumpOn);       // mais secas = maior demanda
+  CHECK(hal::level[29] == LOW && hal::level[31] == LOW && hal::level[28] == HIGH);
+
+  // /pump sem vaga: BUSY; desligar uma libera a vaga para o manual
+  CHECK(!core.manualPump(2, true, 1000));
+  CHECK(core.manualPump(1, false, 0));
+  CHECK(core.manualPump(2, true, 1000) && core.running() == 2);
+
+  // invariante ao longo do tempo: nunca mais que maxPumps e todas as zonas
+  // que querem água acabam atendidas (aging), mesmo a de menor demanda
+  bool served[NZ] = {};
+  for (int k = 0; k < 400; k++){
+    delay(500);
+    core.watchdog();
+    decide(2200);
+    CHECK(onCount(snap) <= core.params().maxPumps);
+    for (int i = 0; i < NZ; i++) served[i] |= snap.z[i].pumpOn;
+  }
+  for (int i = 0; i < NZ; i++) CHECK(served[i]);
+
+  // reservatório baixo: tudo desliga e nada religa
+  for (int i = 0; i < 40; i++){ decide(300); CHECK(onCount(snap) <= core.params().maxPumps); }
+  CHECK(onCount(snap) == 0 && core.running() == 0);
+  for (int i = 0; i < NZ; i++) CHECK(hal::level[28 + i] == HIGH);
+
+  // calibração por zona no blob único: uma gravação na flash
+  Preferences prefs;
+  core.z.soilDry[0] = 3900; core.z.soilDry[3] = 3500;
+  uint32_t c0 = Preferences::commits();
+  core.saveConfig(prefs, "calib");
+  CHECK(Preferences::commits() - c0 == 1);
+  core.z.soilDry[0] = core.z.soilDry[3] = 1;
+  CHECK(!core.loadConfig(prefs, "calib"));
+  CHECK(core.z.soilDry[0] == 3900 && core.z.soilDry[3] == 3500);
+  CHECK(core.params().maxPumps == 2);
+
+  // aquisição em lote: custo de tempo igual ao de uma zona
+  uint64_t t0 = hal::nowUs;
+  int ldr, water;
+  core.acquire(soil, ldr, water);
+  CHECK(hal::nowUs - t0 == 24 * 2000);
+}
+
+int main(){
+  singleZone();
+  multiZone();
+  printf("test_irrigation_core: %s\n", fails ? "FAIL" : "OK");
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+// metrics.h: baldes log2, escopos, exportação Prometheus em blocos e os
+// pontos instrumentados do irrigation_core.h (inclui tempo de bomba ligada).
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "mock_hal.h"
+#include "irrigation_core.h"
+
+static int fails = 0;
+#define CHECK(c) do { if (!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); fails++; } } while (0)
+
+static uint32_t count(metrics::Op op){ return metrics::reg().op[op].n; }
+
+int main(){
+  // baldes: b[i] = [2^i, 2^(i+1))
+  metrics::Histo h = {};
+  h.add(0); h.add(1); h.add(63); h.add(64); h.add(127); h.add(128); h.add(0xFFFFFFFFu);
+  CHECK(h.b[0] == 2 && h.b[5] == 1 && h.b[6] == 2 && h.b[7] == 1 && h.b[31] == 1);
+  CHECK(h.n == 7 && h.max == 0xFFFFFFFFu);
+  CHECK(h.sum == 0 + 1 + 63 + 64 + 127 + 128 + 0xFFFFFFFFull);
+
+  // escopo registra uma amostra ao sair do bloco
+  uint32_t n0 = count(metrics::JSON_FORMAT);
+  { METRIC_SCOPE(JSON_FORMAT); }
+  CHECK(count(metrics::JSON_FORMAT) == n0 + 1);
+  metrics::loopTick(); metrics::loopTick(); metrics::loopTick();
+  CHECK(count(metrics::LOOP_GAP) == 2);
+
+  // pontos instrumentados do controlador
+  hal::reset();
+  DHT dht(22, DHT22);
+  IrrigationCore core({ 35, 39 }, dht);
+  core.addZone({ 34, 26 }); core.addZone({ 32, 27 });
+  core.begin();
+  ZoneSnapshot snap = {};
+  delay(2000);                                       // 1ª leitura do DHT só após 2 s
+  core.sample(snap);
+  CHECK(count(metrics::ACQUIRE) == 1 && count(metrics::DHT_READ) == 1 && count(metrics::SUGENO) == 2);
+  core.sample(snap);                                 // DHT em cache: sem nova leitura
+  CHECK(count(metrics::ACQUIRE) == 2 && count(metrics::DHT_READ) == 1 && count(metrics::SUGENO) == 4);
+  Preferences prefs;
+  core.saveConfig(prefs, "calib");
+  CHECK(count(metrics::NVS_WRITE) == 1);
+
+  // tempo de bomba ligada e acionamentos (pelo relé)
+  core.manualPump(1, true, 3000);
+  delay(1000);
+  CHECK(core.pumpOnMs(1) == 1000);                   // rodada em curso conta
+  delay(2000); core.watchdog();
+  CHECK(core.pumpOnMs(1) == 3000 && core.z.starts[1] == 1);
+  CHECK(core.pumpOnMs(0) == 0 && core.z.starts[0] == 0);
+
+  // exportação: blocos <= 512 B, cumulativo monotônico, +Inf == _count
+  std::string out;
+  std::vector<size_t> chunks;
+  auto sink = [&](const char *b, size_t n){ out.append(b, n); chunks.push_back(n); };
+  {
+    metrics::PromWriter<decltype(sink)> w(sink);
+    w.histograms(metrics::reg());
+    w.meta("irrig_pump_on_seconds_total", "counter", "Tempo de bomba ligada por zona.");
+    w.value("irrig_pump_on_seconds_total", core.pumpOnMs(1) / 1000.0, "zone", "1");
+    w.value("irrig_samples_total", (uint32_t)4000000123u);               // inteiro: exato
+    w.value("irrig_upload_bytes_total", (uint64_t)12345678901234ull);
+    w.value("irrig_uptime_seconds", 1234567.891);
+    w.flush();
+  }
+  CHECK(chunks.size() > 1);
+  for (size_t c : chunks) CHECK(c < 512);
+  CHECK(out.back() == '\n');
+  CHECK(out.find("# TYPE irrig_op_duration_seconds histogram\n") != std::string::npos);
+  CHECK(out.find("irrig_op_duration_seconds_count{op=\"sugeno\"} 4\n") != std::string::npos);
+  CHECK(out.find("irrig_op_duration_seconds_bucket{op=\"sugeno\",le=\"+Inf\"} 4\n") != std::string::npos);
+  CHECK(out.find("irrig_pump_on_seconds_total{zone=\"1\"} 3\n") != std::string::npos);
+  CHECK(out.find("irrig_samples_total 4000000123\n") != std::string::npos);
+  CHECK(out.find("irrig_upload_bytes_total 12345678901234\n") != std::string::npos);
+  CHECK(out.find("irrig_uptime_seconds 1234567.89\n") != std::string::npos);
+
+  unsigned last = 0, lines = 0;
+  const char *key = "irrig_op_duration_seconds_bucket{op=\"acquire\",le=\"";
+  for (size_t p = out.find(key); p != std::string::npos; p = out.find(key, p + 1)){
+    unsigned v = 0;
+    sscanf(out.c_str() + out.find("} ", p) + 2, "%u", &v);
+    CHECK(v >= last);
+    last = v; lines++;
+  }
+  CHECK(lines == 32 - metrics::PromWriter<decltype(sink)>::FIRST_BUCKET + 1 && last == 2);
+
+  printf("test_metrics: %s\n", fails ? "FAIL" : "OK");
+  return fails ? 1 : 0;
+}
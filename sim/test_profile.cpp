@@ -0,0 +1,215 @@
+// profile.h + persistência do irrigation_core.h: perfis de fábrica,
+// validação, troca do perfil ativo por ponteiro (com o decide() em curso),
+// Sugeno externo só com as regras padrão, blob único com CRC e migração das
+// chaves soltas do firmware antigo.
+#include <stdio.h>
+#include <stdlib.h>
+#include "mock_hal.h"
+#include "irrigation_core.h"
+
+static int fails = 0;
+#define CHECK(c) do { if (!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); fails++; } } while (0)
+
+enum { P_SOIL = 34, P_LDR = 35, P_WATER = 39, P_PUMP = 26 };
+
+static int soilRawFor(int pct){ return 4095 - (4095 - 1200) * pct / 100; }
+
+static void validation(){
+  profile::Profile pre[profile::MAX_PROFILES];
+  uint8_t n = profile::presets(pre);
+  CHECK(n >= 2 && !strcmp(pre[0].name, "padrao"));
+  for (uint8_t i = 0; i < n; i++) CHECK(!profile::validate(pre[i], MAX_ZONES));
+
+  profile::Profile p = pre[0];
+  p.par.soilOnTh = p.par.soilOffTh;          CHECK(!strcmp(profile::validate(p, MAX_ZONES), "BAD_SOIL_TH"));
+  p = pre[0]; p.par.maxPumps = MAX_ZONES + 1; CHECK(!strcmp(profile::validate(p, MAX_ZONES), "BAD_MAX_PUMPS"));
+  p = pre[0]; p.par.minRunMs = 30000;         CHECK(!strcmp(profile::validate(p, MAX_ZONES), "BAD_MIN_RUN"));
+  p = pre[0]; p.mf[1][0] = 60;                CHECK(!strcmp(profile::validate(p, MAX_ZONES), "BAD_MF"));   // a > b
+  p = pre[0]; p.ms[0] = 70000;                CHECK(!strcmp(profile::validate(p, MAX_ZONES), "BAD_RULE_MS"));
+  p = pre[0]; strcpy(p.name, "Tomate");       CHECK(!strcmp(profile::validate(p, MAX_ZONES), "BAD_NAME"));
+  p = pre[0]; p.name[0] = 0;                  CHECK(!strcmp(profile::validate(p, MAX_ZONES), "BAD_NAME"));
+
+  // LUT montada em tempo de execução = LUT constexpr do sugeno.h
+  profile::Active a;
+  a.build(pre[0]);
+  CHECK(a.stdRules && !memcmp(&a.lut, &sugeno::Irrigacao::LUT, sizeof(a.lut)));
+  a.build(pre[1]);
+  CHECK(!a.stdRules);
+
+  // /profile: JSON e listas do formulário
+  char js[512];
+  CHECK(profile::formatProfileJson(js, sizeof(js), pre[0], true) > 0);
+  CHECK(strstr(js, "\"name\":\"padrao\",\"active\":true,\"water_min\":15,\"soil_on\":65"));
+  CHECK(strstr(js, "\"dry_low\":[0,10,30],") && strstr(js, "\"l_sol\":[70,85,100]},"));
+  CHECK(strstr(js, "\"rules_ms\":[20000,16000,12000,8000,0,0,6000,4000]}"));
+  CHECK(profile::formatProfileJson(js, 64, pre[0], true) == 0);
+  long v[3];
+  CHECK(profile::parseList("35,50,65", v, 3) && v[0] == 35 && v[1] == 50 && v[2] == 65);
+  CHECK(!profile::parseList("35,50", v, 3) && !profile::parseList("1,2,3,4", v, 3) && !profile::parseList("1,x,3", v, 3));
+
+  // publicação: slot marcado pelo leitor não é reescrito
+  profile::Published<int> pub;
+  int *s = pub.begin(); *s = 1; pub.commit(s);
+  const int *r = pub.acquire();
+  CHECK(*r == 1);
+  s = pub.begin(); CHECK(s && s != r); *s = 2; pub.commit(s);
+  CHECK(*pub.peek() == 2 && *r == 1);                // leitor segue com o antigo
+  CHECK(!pub.begin());                               // o próximo cairia no slot em uso
+  pub.release();
+  CHECK(pub.begin() == r);
+}
+
+static void hotSwap(){
+  hal::reset();
+  DHT dht(22, DHT22);
+  IrrigationCore core({ P_LDR, P_WATER }, dht);
+  core.addZone({ P_SOIL, P_PUMP });
+  core.begin();
+  CHECK(core.profileCount() == 3 && !strcmp(core.profile().name, "padrao"));
+
+  ZoneSnapshot snap = {};
+  int soil[1] = { soilRawFor(51) };                  // 50 %: seco p/ padrão, úmido p/ suculenta
+  for (int i = 0; i < 20; i++) core.decide(soil, 737, 2200, false, snap);   // EMA da água
+  CHECK(snap.z[0].pumpOn);
+  int msStd = snap.z[0].pumpMsSug;
+  CHECK(core.manualPump(0, false, 0));
+
+  CHECK(!core.useProfile("suculenta"));
+  CHECK(core.params().soilOnTh == 30);
+  for (int i = 0; i < 5; i++){ delay(500); core.decide(soil, 737, 2200, false, snap); }
+  CHECK(!snap.z[0].pumpOn);
+  CHECK(abs(snap.z[0].pumpMsSug - msStd * 40 / 100) <= 1);   // singletons a 40 %
+  CHECK(!strcmp(core.useProfile("cacto"), "NO_PROFILE"));
+
+  // troca durante o decide(): o Sugeno externo roda dentro dele (como o FPGA)
+  struct Ctx { IrrigationCore *core; const char *r1, *r2; int calls; } ctx = { &core, nullptr, nullptr, 0 };
+  core.setSugeno([](void *p, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, int &){
+    Ctx &c = *(Ctx*)p;
+    if (c.calls++ == 0){
+      c.r1 = c.core->useProfile("padrao");           // vai para o slot livre
+      c.r2 = c.core->useProfile("suculenta");        // slot em uso pelo decide()
+    }
+    return false;
+  }, &ctx);
+  CHECK(!core.useProfile("padrao"));
+  core.decide(soil, 737, 2200, false, snap);
+  CHECK(ctx.calls == 1 && ctx.r1 == nullptr && !strcmp(ctx.r2, "BUSY"));
+  CHECK(!strcmp(core.profile().name, "padrao"));
+  CHECK(!core.useProfile("suculenta"));             // decide() terminou: liberado
+
+  // regras próprias: o Sugeno externo não é consultado
+  core.decide(soil, 737, 2200, false, snap);
+  CHECK(ctx.calls == 1);
+  CHECK(!core.useProfile("padrao"));
+  core.decide(soil, 737, 2200, false, snap);
+  CHECK(ctx.calls == 2);
+
+  // catálogo: inclui, atualiza o ativo (republica), cheio, remove
+  profile::Profile p = profile::make("tomate", { 20, 55, 65, 15000, 1, 3000 });
+  CHECK(!core.putProfile(p) && core.profileCount() == 4);
+  CHECK(!strcmp(core.putProfile(profile::make("alface", CORE_DEFAULTS)), "FULL"));
+  p.par.soilOffTh = 10;
+  CHECK(!strcmp(core.putProfile(p), "BAD_SOIL_TH"));
+  CHECK(!core.useProfile("tomate") && core.params().pumpMaxMs == 15000);
+  p.par.soilOffTh = 70;
+  CHECK(!core.putProfile(p) && core.params().soilOffTh == 70 && core.profileCount() == 4);
+  CHECK(!strcmp(core.removeProfile("tomate"), "ACTIVE"));
+  CHECK(!core.removeProfile("hortalica") && core.profileCount() == 3);
+  CHECK(core.activeProfile() == 2 && !strcmp(core.profile().name, "tomate"));
+
+  // BUSY não deixa nada pela metade: incluir+ativar e recarregar a NVS
+  // durante o decide() (o 1º publish ocupa o slot livre) não mudam nada
+  Preferences prefs;
+  core.saveConfig(prefs, "busy");
+  int wf = core.cal.waterFull;
+  core.cal.waterFull = 1234;
+  struct Busy { IrrigationCore *core; Preferences *prefs; const char *put, *load; } bz = { &core, &prefs, nullptr, nullptr };
+  core.setSugeno([](void *p, uint8_t, uint8_t, uint8_t, uint8_t, uint8_t, int &){
+    Busy &b = *(Busy*)p;
+    if (!b.put && !b.core->useProfile("tomate")){
+      b.put  = b.core->putProfile(profile::make("alface", CORE_DEFAULTS), true);
+      b.load = b.core->loadConfig(*b.prefs, "busy");
+    }
+    return false;
+  }, &bz);
+  core.decide(soil, 737, 2200, false, snap);
+  CHECK(bz.put && !strcmp(bz.put, "BUSY") && bz.load && !strcmp(bz.load, "BUSY"));
+  CHECK(core.profileCount() == 3 && core.findProfile("alface") < 0);
+  CHECK(!strcmp(core.profile().name, "tomate") && core.cal.waterFull == 1234);
+  CHECK(!core.putProfile(profile::make("alface", CORE_DEFAULTS), true));   // fora do decide()
+  CHECK(core.profileCount() == 4 && !strcmp(core.profile().name, "alface"));
+  CHECK(!core.loadConfig(prefs, "busy"));
+  CHECK(core.cal.waterFull == wf && core.profileCount() == 3 && !strcmp(core.profile().name, "tomate"));
+}
+
+static void persistence(){
+  hal::reset();
+  DHT dht(22, DHT22);
+  Preferences prefs;
+  {
+    IrrigationCore core({ P_LDR, P_WATER }, dht);
+    core.addZone({ P_SOIL, P_PUMP }); core.addZone({ 32, 27 });
+    core.z.soilDry[1] = 3500;  core.cal.waterFull = 2500;
+    CHECK(!core.putProfile(profile::make("tomate", { 20, 55, 65, 15000, 2, 3000 })));
+    CHECK(!core.useProfile("tomate"));
+    uint32_t c0 = Preferences::commits();
+    core.saveConfig(prefs, "cfgtest");
+    CHECK(Preferences::commits() - c0 == 1);
+  }
+  {
+    IrrigationCore core({ P_LDR, P_WATER }, dht);
+    core.addZone({ P_SOIL, P_PUMP }); core.addZone({ 32, 27 });
+    CHECK(!core.loadConfig(prefs, "cfgtest"));
+    CHECK(core.z.soilDry[1] == 3500 && core.cal.waterFull == 2500);
+    CHECK(core.profileCount() == 4 && !strcmp(core.profile().name, "tomate"));
+    CHECK(core.params().maxPumps == 2 && core.params().soilOnTh == 55);
+  }
+
+  // 1 bit trocado ou versão diferente: blob ignorado, fica o de fábrica
+  std::string &blob = Preferences::store()["cfgtest"]["cfg"];
+  std::string good = blob;
+  blob[offsetof(ConfigBlob, prof) + 20] ^= 1;
+  {
+    IrrigationCore core({ P_LDR, P_WATER }, dht);
+    core.addZone({ P_SOIL, P_PUMP });
+    CHECK(!strcmp(core.loadConfig(prefs, "cfgtest"), "NO_DATA"));
+    CHECK(!strcmp(core.profile().name, "padrao") && core.cal.waterFull == CAL_DEFAULTS.waterFull);
+  }
+  blob = good;
+  ConfigBlob b;
+  memcpy(&b, blob.data(), sizeof(b));
+  b.version = CFG_VERSION + 1;
+  b.crc = profile::crc32(&b, offsetof(ConfigBlob, crc));
+  blob.assign((const char*)&b, sizeof(b));
+  {
+    IrrigationCore core({ P_LDR, P_WATER }, dht);
+    core.addZone({ P_SOIL, P_PUMP });
+    CHECK(!strcmp(core.loadConfig(prefs, "cfgtest"), "NO_DATA"));
+  }
+
+  // firmware antigo: chaves soltas -> carrega a calibração; salvar migra
+  prefs.begin("legacy", false);
+  prefs.putInt("SOIL_DRY", 3800); prefs.putInt("SOIL_WET", 1300);
+  prefs.putInt("LDR_DARK", 400);  prefs.putInt("W_FULL", 2100);
+  prefs.end();
+  {
+    IrrigationCore core({ P_LDR, P_WATER }, dht);
+    core.addZone({ P_SOIL, P_PUMP });
+    CHECK(!core.loadConfig(prefs, "legacy"));
+    CHECK(core.z.soilDry[0] == 3800 && core.cal.ldrDark == 400 && core.cal.waterFull == 2100);
+    core.saveConfig(prefs, "legacy");
+    prefs.begin("legacy", true);
+    CHECK(prefs.isKey("cfg") && !prefs.isKey("SOIL_DRY") && !prefs.isKey("W_FULL"));
+    prefs.end();
+    core.z.soilDry[0] = 1;
+    CHECK(!core.loadConfig(prefs, "legacy") && core.z.soilDry[0] == 3800);
+  }
+}
+
+int main(){
+  validation();
+  hotSwap();
+  persistence();
+  printf("test_profile: %s\n", fails ? "FAIL" : "OK");
+  return fails ? 1 : 0;
+}
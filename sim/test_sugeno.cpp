@@ -0,0 +1,25 @@
+// Equivalência bit-a-bit: sugeno.h x implementação original, para todo
+// dry 0..100, temp 0..50, luz 0..100 (101 x 51 x 101 combinações).
+#include <stdio.h>
+#include "sugeno.h"
+#include "reference_fuzzy.h"
+
+int main(){
+  long n = 0, bad = 0;
+  for (int dry = 0; dry <= 100; dry++)
+    for (int t = 0; t <= 50; t++)
+      for (int lz = 0; lz <= 100; lz++){
+        int rid_ref = 0;
+        int ms_ref  = ref::decide(dry, t, lz, rid_ref);
+        const uint8_t in[3] = { (uint8_t)dry, (uint8_t)t, (uint8_t)lz };
+        sugeno::Decision d = sugeno::Irrigacao::eval(in);
+        n++;
+        if (d.ms != ms_ref || d.rule != rid_ref){
+          if (bad++ < 10)
+            printf("FAIL dry=%d t=%d lz=%d: ms %d/%d rule %d/%d\n",
+                   dry, t, lz, (int)d.ms, ms_ref, d.rule, rid_ref);
+        }
+      }
+  printf("test_sugeno: %ld combinações, %ld divergências\n", n, bad);
+  return bad ? 1 : 0;
+}
@@ -0,0 +1,283 @@
+// upload_queue.h contra uma nuvem de mentira servida pelo http_server.h
+// (transporte em memória, HTTP de verdade): lote binário ida e volta, 1
+// requisição por lote, POST que passa do timeout sem rasgar o lote, queda
+// do servidor com backoff exponencial e esvaziamento da fila, resposta
+// perdida (reenvio sem duplicar), reboot retomando do cursor salvo na NVS,
+// STA fora e anel do histórico dando a volta durante uma queda longa.
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include "mock_hal.h"
+#include "http_server.h"
+#include "mem_net.h"
+#include "upload_queue.h"
+
+static int fails = 0;
+#define CHECK(c) do { if (!(c)) { printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); fails++; } } while (0)
+
+struct MemStorage {
+  std::vector<uint8_t> mem;
+  explicit MemStorage(size_t n) : mem(n, 0) {}
+  bool read(uint32_t off, void *buf, size_t n){
+    if (off + n > mem.size()) return false;
+    memcpy(buf, &mem[off], n); return true;
+  }
+  bool write(uint32_t off, const void *buf, size_t n){
+    if (off + n > mem.size()) return false;
+    memcpy(&mem[off], buf, n); return true;
+  }
+};
+typedef HistoryLog<MemStorage, 8> Log;   // 1360 registros ≈ 22 h a 1/min
+
+/* ---------------- nuvem de mentira ---------------- */
+typedef http::Server<MemNet, 4> Srv;
+enum Mode { UP, DOWN, DROP_ONCE };
+
+static struct Cloud {
+  std::map<uint32_t, HistRecord> got;
+  uint32_t posts = 0, dups = 0, bad = 0;
+  Mode mode = UP;
+} cloud;
+static Srv *srv;
+
+static void handleIngest(){
+  cloud.posts++;
+  if (cloud.mode == DOWN){ srv->send(503, "text/plain", "DOWN"); return; }
+  bool ok = upload::decodeBatch((const uint8_t*)srv->body(), srv->bodyLen(), [](uint32_t seq, const HistRecord &r){
+    if (!cloud.got.emplace(seq, r).second) cloud.dups++;
+  });
+  if (!ok){ cloud.bad++; srv->send(400, "text/plain", "BAD_BATCH"); return; }
+  if (cloud.mode == DROP_ONCE){ cloud.mode = UP; srv->detach().stop(); return; }   // gravou e caiu sem responder
+  srv->send(200, "text/plain", "ACK");
+}
+
+// POST para a nuvem de mentira, uma conexão por lote
+struct StandInLink {
+  MemNet &net;
+  Srv    &srv;
+  std::shared_ptr<Pipe> p;
+
+  bool start(const uint8_t *b, size_t n, uint32_t){
+    if (p) return false;
+    char h[192];
+    snprintf(h, sizeof(h), "POST /ingest HTTP/1.1\r\nHost: cloud\r\nContent-Type: %s\r\n"
+                           "Content-Length: %zu\r\nConnection: close\r\n\r\n", upload::BATCH_MIME, n);
+    p = net.connect(std::string(h) + std::string((const char*)b, n));
+    return true;
+  }
+  int poll(uint32_t nowMs){
+    if (!p) return -1;
+    for (int i = 0; i < 4; i++) srv.poll(nowMs);
+    if (p->out.find("\r\n\r\n") != std::string::npos){ int code = atoi(p->out.c_str() + 9); p.reset(); return code; }
+    if (!p->open){ p.reset(); return -1; }
+    return 0;
+  }
+  bool idle(){ return !p; }
+};
+
+// POST que passa do TIMEOUT_MS da fila (DNS + connect + leitura lentos) e
+// continua lendo o body até terminar: o body lido no fim tem de ser o do início
+struct SlowLink {
+  const uint8_t *body = nullptr;
+  std::string    copy;
+  uint32_t       doneMs = 0, posts = 0, torn = 0;
+  bool           busy = false;
+
+  bool start(const uint8_t *b, size_t n, uint32_t nowMs){
+    if (busy) return false;
+    body = b;  copy.assign((const char*)b, n);
+    busy = true;  posts++;
+    doneMs = nowMs + (posts == 1 ? 20 * 60000 : 1000);    // o 1º passa do timeout (e de um flush)
+    return true;
+  }
+  int poll(uint32_t nowMs){ step(nowMs); return busy ? 0 : 200; }
+  bool idle(){ return !busy; }
+  // a task do HTTPClient segue sozinha, mesmo sem poll()
+  void step(uint32_t nowMs){
+    if (!busy || (int32_t)(nowMs - doneMs) < 0) return;
+    if (memcmp(body, copy.data(), copy.size())) torn++;
+    busy = false;
+  }
+};
+
+typedef upload::UploadQueue<Log, StandInLink> Queue;
+
+/* ---------------- dispositivo ---------------- */
+const uint32_t T0 = 1700000000;
+static MemNet net;
+static uint32_t t = 0;                    // segundos simulados
+
+static HistRecord rec(uint32_t ts){
+  HistRecord r = {};
+  uint32_t i = ts / 60;
+  r.ts = ts;
+  r.soilRaw = 2500 + (i * 7) % 41 - 20;  r.ldrRaw = 1800 + (i * 13) % 61 - 30;  r.waterRaw = 2100 - i % 50;
+  r.temp_dC = (i % 500 == 0) ? INT16_MIN : 245 + (i % 30) - 15;
+  r.humid_dPct = 610;  r.pumpMsSug = (i % 20) ? 0 : 8000;
+  r.soilPct = 55 - i % 3;  r.ldrPct = 48;  r.waterPct = 95;
+  r.flags = (i % 20 ? 0 : HIST_PUMP_ON) | (r.temp_dC != INT16_MIN ? HIST_DHT_OK : 0);
+  r.ruleId = 4;
+  return r;
+}
+
+struct Device {
+  Log         log;
+  StandInLink link;
+  Queue       q;
+  Preferences prefs;
+  std::vector<uint32_t> attempts;        // t de cada POST
+
+  Device(MemStorage &st, Srv &s) : log(st), link{ net, s, nullptr }, q(log, link) {
+    log.begin();
+    q.seed(42);
+    q.loadCursor(prefs, "upload");
+  }
+
+  // 1 registro/min (como o historyTick) e 1 volta do loop por segundo
+  void run(uint32_t seconds, bool online = true){
+    for (uint32_t end = t + seconds; t < end; t++){
+      if (t % 60 == 0) log.append(rec(T0 + t), T0 + t);
+      uint32_t r0 = q.requests();
+      if (q.tick(t * 1000, T0 + t, online)) q.saveCursor(prefs, "upload");
+      if (q.requests() != r0) attempts.push_back(t);
+    }
+  }
+};
+
+// Nuvem recebeu todo o trecho [from, to)
+static bool cloudHas(uint32_t from, uint32_t to){
+  for (uint32_t s = from; s < to; s++) if (!cloud.got.count(s)) return false;
+  return true;
+}
+
+static void codec(){
+  uint8_t buf[Queue::BUF_SIZE];
+  upload::BatchWriter w(buf, sizeof(buf));
+  HistRecord in[40];
+  uint32_t seqs[40];
+  int n = 0;
+  for (uint32_t i = 0; i < 40; i++){
+    in[i] = rec(T0 + i * 60);
+    seqs[i] = 1000 + i + (i > 20);                       // um buraco (registro com CRC ruim)
+    if (i == 5){ in[i].temp_dC = INT16_MIN; in[i].ts = 0; }
+    if (i == 6){ in[i].soilRaw = 65535; in[i].pumpMsSug = 65535; }
+    CHECK(w.add(seqs[i], in[i]));
+  }
+  size_t len = w.finish();
+  CHECK(len < 40 * 16);                                  // ~12 B por registro (24 B crus)
+  upload::decodeBatch(buf, len, [&](uint32_t seq, const HistRecord &r){
+    CHECK(seq == seqs[n] && !memcmp(&r, &in[n], offsetof(HistRecord, gen)));
+    n++;
+  });
+  CHECK(n == 40);
+  CHECK(!upload::decodeBatch(buf, len - 1, [](uint32_t, const HistRecord &){}));
+  buf[0] ^= 1;
+  CHECK(!upload::decodeBatch(buf, len, [](uint32_t, const HistRecord &){}));
+
+  // lote cheio: add() recusa antes de estourar o buffer
+  upload::BatchWriter small(buf, 100);
+  int added = 0;
+  HistRecord wild = rec(T0);
+  while (small.add(added, wild)){ wild.ts ^= 0x7FFFFFFF; wild.soilRaw ^= 0xFFFF; added++; }
+  CHECK(added > 0 && small.finish() <= 100);
+}
+
+static void slowPost(){
+  MemStorage st(Log::FILE_SIZE);
+  Log log(st);
+  log.begin();
+  SlowLink link;
+  upload::UploadQueue<Log, SlowLink> q(log, link);
+  for (uint32_t s = 0; s < 4 * 3600; s++){
+    if (s % 60 == 0) log.append(rec(T0 + s), T0 + s);
+    link.step(s * 1000);
+    q.tick(s * 1000, T0 + s, true);
+  }
+  CHECK(link.posts > 2 && link.torn == 0);
+  CHECK(q.failures() == 1 && q.backlog() <= Queue::BATCH_RECS);
+}
+
+static void storeAndForward(){
+  Srv s(net); srv = &s;
+  s.on("/ingest", http::POST, handleIngest);
+  MemStorage st(Log::FILE_SIZE);
+
+  {
+    Device d(st, s);
+
+    // 2 h normais: 1 requisição por BATCH_RECS registros, nada duplicado
+    d.run(2 * 3600);
+    CHECK(cloud.bad == 0 && cloud.dups == 0);
+    CHECK(cloud.posts <= 120 / Queue::BATCH_RECS + 1);
+    CHECK(d.q.backlog() <= Queue::BATCH_RECS);
+    CHECK(cloudHas(0, d.q.acked()) && d.q.acked() >= 100);
+    CHECK(d.q.bytes() / d.q.sent() <= 16);
+
+    // 3 h de servidor fora: tentativas espaçadas em backoff exponencial
+    cloud.mode = DOWN;
+    size_t a0 = d.attempts.size();
+    uint32_t acked0 = d.q.acked();
+    d.run(3 * 3600);
+    size_t nDown = d.attempts.size() - a0;
+    CHECK(nDown >= 8 && nDown <= 16);
+    CHECK(d.q.acked() == acked0 && d.q.failStreak() == nDown);
+    bool growing = true;
+    for (size_t i = a0 + 2; i < d.attempts.size(); i++){
+      uint32_t gap = d.attempts[i] - d.attempts[i - 1], prev = d.attempts[i - 1] - d.attempts[i - 2];
+      if (gap + 1 < prev && gap < Queue::BACKOFF_MAX_MS / 1000) growing = false;
+      if (gap > Queue::BACKOFF_MAX_MS / 1000 * 5 / 4 + 1) growing = false;
+    }
+    CHECK(growing);
+
+    // volta: o atraso acumulado sai em lotes de até MAX_RECS seguidos
+    cloud.mode = UP;
+    d.run(3600);
+    CHECK(d.q.failStreak() == 0 && d.q.backlog() <= Queue::BATCH_RECS);
+    CHECK(cloudHas(0, d.q.acked()) && cloud.dups == 0);
+
+    // resposta perdida: o lote volta, a nuvem descarta o repetido
+    cloud.mode = DROP_ONCE;
+    d.run(3600);
+    CHECK(cloud.mode == UP && cloud.dups > 0 && d.q.failures() > nDown);
+    CHECK(cloudHas(0, d.q.acked()));
+
+    // STA fora: nada sai
+    uint32_t r0 = d.q.requests();
+    d.run(3600, false);
+    CHECK(d.q.requests() == r0);
+    d.run(3600);
+    CHECK(d.q.requests() > r0);
+  }
+
+  // reboot: índice do histórico refeito da flash, cursor da NVS; o que já
+  // foi confirmado não é reenviado e nada fica para trás
+  uint32_t dups0 = cloud.dups;
+  {
+    Device d(st, s);
+    CHECK(d.q.acked() > 0 && d.q.acked() <= d.log.endSeq());
+    d.run(2 * 3600);
+    CHECK(cloud.dups == dups0 && cloudHas(0, d.q.acked()) && d.q.lost() == 0);
+
+    // queda maior que o anel (~22 h): o que foi sobrescrito conta como perdido
+    uint32_t before = d.q.acked();
+    cloud.mode = DOWN;
+    d.run(30 * 3600);
+    cloud.mode = UP;
+    d.run(6 * 3600);
+    CHECK(d.q.lost() > 0 && d.q.failStreak() == 0);
+    CHECK(cloudHas(before + d.q.lost(), d.q.acked()));
+    CHECK(!cloud.got.count(before) && cloud.got.count(before - 1));
+    CHECK(d.q.backlog() <= Queue::BATCH_RECS);
+    printf("  nuvem: %u registros em %u requisições (%u repetidos); após o reboot %.1f B no ar por registro, %u perdidos\n",
+           (unsigned)cloud.got.size(), (unsigned)cloud.posts, (unsigned)cloud.dups,
+           (double)d.q.bytes() / d.q.sent(), (unsigned)d.q.lost());
+  }
+}
+
+int main(){
+  codec();
+  slowPost();
+  storeAndForward();
+  printf("test_upload: %s\n", fails ? "FAIL" : "OK");
+  return fails ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+#pragma once
+/*
+ * Motor Sugeno 0-ordem dirigido por tabela (espelha FPGA/logica_irrigacao.txt).
+ *
+ * Variáveis, conjuntos triangulares e regras são descritos em tabelas
+ * constexpr (ver IrrigacaoModel). Cada conjunto vira uma LUT de 256 entradas
+ * (uint8 -> pertinência 0..255) gerada em tempo de compilação, então a
+ * fuzzificação é só indexação. As regras são AND (min) de até 3 termos, cada
+ * termo um OR (max) de até 2 conjuntos; termos não usados apontam para o
+ * conjunto UM (pertinência constante 255, neutro do min). A avaliação é um
+ * laço fixo sem desvios dependentes de dado.
+ *
+ * Os pontos a-b-c e os singletons do modelo são o padrão; um perfil de
+ * planta (profile.h) pode trocá-los em tempo de execução com uma LUT própria.
+ * A estrutura das regras (quais conjuntos entram em cada uma) é fixa.
+ *
+ * Sem dependências do Arduino: compila também no host (sim/).
+ */
+#include <stdint.h>
+
+namespace sugeno {
+
+struct Tri  { uint8_t var, a, b, c; };          // conjunto triangular a-b-c sobre a variável var
+struct Term { uint8_t s0, s1; };                // s0 OR s1
+struct Rule { Term t[3]; int32_t ms; };         // t0 AND t1 AND t2 -> singleton (ms)
+
+// Pertinência triangular 0..255 (idêntica ao tri_mu() original, inclusive arredondamento)
+constexpr uint8_t triMu(int x, int a, int b, int c){
+  return (x<=a || x>=c) ? 0
+       : (x==b)         ? 255
+       : (x>b)          ? (uint8_t)((c - x) * 255 / (c - b))
+       :                  (uint8_t)((x - a) * 255 / (b - a));
+}
+
+template <int NSETS>
+struct LutTable { uint8_t mu[NSETS + 1][256]; };   // +1: conjunto UM
+
+// Preenche a LUT de um conjunto; também usado em tempo de execução quando
+// um perfil troca os pontos a-b-c (ver profile.h)
+template <int NSETS>
+constexpr void fillLut(LutTable<NSETS> &t, int s, int a, int b, int c){
+  for (int x = 0; x < 256; x++) t.mu[s][x] = triMu(x, a, b, c);
+}
+
+template <class M>
+constexpr LutTable<M::NSETS> buildLut(){
+  LutTable<M::NSETS> t{};
+  for (int s = 0; s < M::NSETS; s++) fillLut(t, s, M::SETS[s].a, M::SETS[s].b, M::SETS[s].c);
+  for (int x = 0; x < 256; x++) t.mu[M::NSETS][x] = 255;
+  return t;
+}
+
+template <int NRULES>
+struct Singletons { int32_t ms[NRULES]; };
+
+template <class M>
+constexpr Singletons<M::NRULES> buildSingletons(){
+  Singletons<M::NRULES> t{};
+  for (int r = 0; r < M::NRULES; r++) t.ms[r] = M::RULES[r].ms;
+  return t;
+}
+
+struct Decision { int32_t ms; uint8_t rule; };     // rule: 1..N dominante, 0 = nenhuma ativa
+
+template <class M>
+struct Engine {
+  static constexpr LutTable<M::NSETS>     LUT = buildLut<M>();
+  static constexpr Singletons<M::NRULES>  MS  = buildSingletons<M>();
+
+  static inline uint8_t umin(uint8_t a, uint8_t b){ return a < b ? a : b; }
+  static inline uint8_t umax(uint8_t a, uint8_t b){ return a > b ? a : b; }
+
+  // in[v] = valor crisp (0..255) da variável v
+  static Decision eval(const uint8_t in[M::NVARS]){ return eval(in, LUT, MS.ms); }
+
+  // Mesma estrutura de regras com conjuntos e singletons vindos de um perfil
+  static Decision eval(const uint8_t in[M::NVARS], const LutTable<M::NSETS> &lut, const int32_t ms[M::NRULES]){
+    uint8_t mu[M::NSETS + 1];
+    for (int s = 0; s < M::NSETS; s++) mu[s] = lut.mu[s][in[M::SETS[s].var]];
+    mu[M::NSETS] = 255;
+
+    uint32_t num = 0, den = 0;
+    uint8_t  maxw = 0, rid = 0;
+    for (int r = 0; r < M::NRULES; r++){
+      const Rule &R = M::RULES[r];
+      uint8_t w = umin(umax(mu[R.t[0].s0], mu[R.t[0].s1]),
+                  umin(umax(mu[R.t[1].s0], mu[R.t[1].s1]),
+                       umax(mu[R.t[2].s0], mu[R.t[2].s1])));
+      num += (uint32_t)w * (uint32_t)ms[r];
+      den += w;
+      // regra dominante: primeiro máximo estrito (mesmo critério do código antigo)
+      bool gt = w > maxw;
+      maxw = gt ? w : maxw;
+      rid  = gt ? (uint8_t)(r + 1) : rid;
+    }
+    Decision d;
+    d.rule = rid;
+    d.ms   = den ? (int32_t)(num / den) : 0;
+    return d;
+  }
+};
+
+template <class M>
+constexpr LutTable<M::NSETS> Engine<M>::LUT;
+template <class M>
+constexpr Singletons<M::NRULES> Engine<M>::MS;
+
+/* ---------------- Modelo de irrigação (3 entradas, 8 regras) ---------------- */
+struct IrrigacaoModel {
+  enum Var : uint8_t { DRY, TEMP, LUZ, NVARS_ };
+  enum Set : uint8_t {
+    DRY_LOW, DRY_MED, DRY_HIGH,
+    T_FRIO,  T_AGRAD, T_QUENTE,
+    L_ESCURO, L_NUBL, L_SOL,
+    NSETS_, UM = NSETS_
+  };
+  static constexpr int NVARS  = NVARS_;
+  static constexpr int NSETS  = NSETS_;
+  static constexpr int NRULES = 8;
+
+  static constexpr Tri SETS[NSETS] = {
+    {DRY, 0,10,30},  {DRY, 35,50,65}, {DRY, 70,90,100},   // dry% = 100 - umidade
+    {TEMP,0,10,15},  {TEMP,18,23,28}, {TEMP,28,35,45},    // °C
+    {LUZ, 0,5,15},   {LUZ, 40,50,60}, {LUZ, 70,85,100},   // luz%
+  };
+
+  static constexpr Rule RULES[NRULES] = {
+    {{{DRY_HIGH,DRY_HIGH}, {T_QUENTE,T_QUENTE}, {L_SOL,L_SOL}},   20000},  // R1
+    {{{DRY_HIGH,DRY_HIGH}, {T_QUENTE,T_AGRAD},  {UM,UM}},         16000},  // R2
+    {{{DRY_MED, DRY_MED},  {T_QUENTE,T_QUENTE}, {L_SOL,L_SOL}},   12000},  // R3
+    {{{DRY_MED, DRY_MED},  {T_QUENTE,T_AGRAD},  {UM,UM}},          8000},  // R4
+    {{{DRY_LOW, DRY_LOW},  {UM,UM},             {UM,UM}},             0},  // R5
+    {{{T_FRIO,  T_FRIO},   {L_ESCURO,L_ESCURO}, {UM,UM}},             0},  // R6
+    {{{DRY_HIGH,DRY_HIGH}, {L_ESCURO,L_ESCURO}, {UM,UM}},          6000},  // R7
+    {{{DRY_MED, DRY_MED},  {L_ESCURO,L_ESCURO}, {UM,UM}},          4000},  // R8
+  };
+};
+
+constexpr Tri  IrrigacaoModel::SETS[];
+constexpr Rule IrrigacaoModel::RULES[];
+
+typedef Engine<IrrigacaoModel> Irrigacao;
+
+} // namespace sugeno
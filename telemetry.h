@@ -0,0 +1,64 @@
+#pragma once
+/*
+ * Snapshot de telemetria publicado pela task de amostragem.
+ *
+ * Um único escritor (samplerTask) e N leitores (handlers HTTP). O buffer é
+ * duplo + contador de sequência (estilo seqlock): o escritor sempre grava no
+ * slot que os leitores NÃO estão lendo e só depois publica; o leitor copia o
+ * slot atual e confere a sequência, repetindo se o escritor deu a volta.
+ * Nenhum lado bloqueia, então /data nunca espera pelo ADC nem pelo DHT.
+ *
+ * Sem dependências do Arduino: compila também no host.
+ */
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+struct Telemetry {
+  uint32_t seq;          // nº da amostra (0 = ainda não houve amostra)
+  uint32_t ts_ms;        // millis() da aquisição
+
+  int16_t  soilRaw, ldrRaw;
+  int16_t  waterRaw;     // média instantânea (usada na calibração)
+  int16_t  waterRawEma;  // filtrada (usada na decisão)
+  uint8_t  soilPct, ldrPct, waterPct;
+
+  bool     dhtOk;
+  float    tempC, humid;
+
+  bool     pumpOn;
+  int32_t  pumpMsSug;
+  uint8_t  ruleId;
+};
+
+template <typename T>
+class SnapshotBuffer {
+public:
+  // Apenas um escritor. seq par = estável; o slot legível é (seq>>1)&1.
+  void publish(const T& v){
+    uint32_t s = seq_.load(std::memory_order_relaxed);
+    seq_.store(s + 1, std::memory_order_relaxed);           // ímpar: escrevendo
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot_[((s >> 1) + 1) & 1], &v, sizeof(T));
+    seq_.store(s + 2, std::memory_order_release);           // par: publicado
+  }
+
+  // Copia o último snapshot publicado. Nunca bloqueia; repete só se o
+  // escritor começou a sobrescrever o slot durante a cópia (2 publicações).
+  void read(T& out) const {
+    for (;;){
+      uint32_t s1   = seq_.load(std::memory_order_acquire);
+      uint32_t base = s1 & ~1u;
+      memcpy(&out, &slot_[(base >> 1) & 1], sizeof(T));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      uint32_t s2 = seq_.load(std::memory_order_relaxed);
+      if (s2 - base <= 2) return;
+    }
+  }
+
+  uint32_t version() const { return seq_.load(std::memory_order_acquire) >> 1; }
+
+private:
+  T slot_[2] = {};
+  std::atomic<uint32_t> seq_{0};
+};
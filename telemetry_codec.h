@@ -0,0 +1,99 @@
+#pragma once
+/*
+ * Codificação do /data: JSON (formato histórico) e binário v1.
+ *
+ * O binário é um struct empacotado little-endian com ponto fixo, sem nomes
+ * de campo e sem a calibração: esta fica no recurso /cal?type=show, com
+ * ETag. O payload leva calTag (= ETag) para o cliente saber quando buscar
+ * a calibração de novo. Tensões não vão no fio: v = raw * 3.3 / 4095.
+ *
+ * Decodificador correspondente: Dashboard/src/api/esp.ts.
+ * Sem dependências do Arduino: compila também no host (sim/).
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "telemetry.h"
+
+struct CalValues {
+  int16_t soilDry, soilWet, ldrDark, ldrLight, waterEmpty, waterFull;
+};
+
+// ETag da calibração (FNV-1a 32 bits sobre os valores)
+inline uint32_t calTag(const CalValues &c){
+  const uint8_t *p = (const uint8_t*)&c;
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < sizeof(c); i++){ h ^= p[i]; h *= 16777619u; }
+  return h;
+}
+
+inline size_t formatCalJson(char *out, size_t cap, const CalValues &c){
+  int n = snprintf(out, cap,
+    "{\"soil_dry\":%d,\"soil_wet\":%d,\"ldr_dark\":%d,\"ldr_light\":%d,\"water_empty\":%d,\"water_full\":%d}",
+    c.soilDry, c.soilWet, c.ldrDark, c.ldrLight, c.waterEmpty, c.waterFull);
+  return (n > 0 && (size_t)n < cap) ? (size_t)n : 0;
+}
+
+// Resposta JSON do /data (mesmos campos de sempre). vPerCount = VREF / ADCMAX.
+inline size_t formatTelemetryJson(char *out, size_t cap, const Telemetry &s, const CalValues &c, float vPerCount){
+  int n = snprintf(out, cap,
+    "{"
+      "\"soil_raw\":%d,\"soil_v\":%.3f,\"soil_pct\":%d,\"soil_dry\":%d,\"soil_wet\":%d,"
+      "\"ldr_raw\":%d,\"ldr_v\":%.3f,\"ldr_pct\":%d,\"ldr_dark\":%d,\"ldr_light\":%d,"
+      "\"temp_c\":%.1f,\"humid\":%.0f,\"dht_ok\":%s,"
+      "\"water_raw\":%d,\"water_v\":%.3f,\"water_pct\":%d,"
+      "\"water_empty\":%d,\"water_full\":%d,"
+      "\"pump_on\":%s,\"pump_ms_sug\":%d,\"rule_id\":%d,\"seq\":%u"
+    "}",
+    s.soilRaw, s.soilRaw * vPerCount, s.soilPct, c.soilDry, c.soilWet,
+    s.ldrRaw,  s.ldrRaw  * vPerCount, s.ldrPct,  c.ldrDark, c.ldrLight,
+    s.tempC, s.humid, s.dhtOk ? "true" : "false",
+    s.waterRawEma, s.waterRawEma * vPerCount, s.waterPct,
+    c.waterEmpty, c.waterFull,
+    s.pumpOn ? "true" : "false", (int)s.pumpMsSug, s.ruleId, (unsigned)s.seq);
+  return (n > 0 && (size_t)n < cap) ? (size_t)n : 0;
+}
+
+/* ---------------- binário v1 (30 bytes) ---------------- */
+const uint8_t TELEMETRY_BIN_VERSION = 1;
+enum : uint8_t { TBIN_DHT_OK = 1, TBIN_PUMP_ON = 2 };
+
+#pragma pack(push, 1)
+struct TelemetryBin {
+  uint8_t  ver;          // TELEMETRY_BIN_VERSION
+  uint8_t  flags;        // TBIN_*
+  uint8_t  soilPct, ldrPct, waterPct, ruleId;
+  uint16_t pumpMsSug;
+  uint32_t seq;
+  uint32_t tsMs;
+  uint32_t calTag;
+  uint16_t soilRaw, ldrRaw, waterRaw;
+  int16_t  temp_dC;      // °C x10
+  uint16_t humid_dPct;   // % x10
+};
+#pragma pack(pop)
+static_assert(sizeof(TelemetryBin) == 30, "TelemetryBin deve ter 30 bytes");
+// offsets usados pelo decodificador do dashboard
+static_assert(offsetof(TelemetryBin, seq) == 8 && offsetof(TelemetryBin, calTag) == 16 &&
+              offsetof(TelemetryBin, soilRaw) == 20 && offsetof(TelemetryBin, humid_dPct) == 28,
+              "layout do TelemetryBin mudou: atualize esp.ts e TELEMETRY_BIN_VERSION");
+
+// ESP32 e x86 são little-endian: o struct vai direto para o fio.
+inline size_t encodeTelemetryBin(uint8_t *out, size_t cap, const Telemetry &s, uint32_t tag){
+  if (cap < sizeof(TelemetryBin)) return 0;
+  TelemetryBin b;
+  b.ver        = TELEMETRY_BIN_VERSION;
+  b.flags      = (s.dhtOk ? TBIN_DHT_OK : 0) | (s.pumpOn ? TBIN_PUMP_ON : 0);
+  b.soilPct    = s.soilPct;  b.ldrPct = s.ldrPct;  b.waterPct = s.waterPct;  b.ruleId = s.ruleId;
+  b.pumpMsSug  = (uint16_t)s.pumpMsSug;
+  b.seq        = s.seq;
+  b.tsMs       = s.ts_ms;
+  b.calTag     = tag;
+  b.soilRaw    = (uint16_t)s.soilRaw;  b.ldrRaw = (uint16_t)s.ldrRaw;  b.waterRaw = (uint16_t)s.waterRawEma;
+  b.temp_dC    = s.dhtOk ? (int16_t)lroundf(s.tempC * 10) : 0;
+  b.humid_dPct = s.dhtOk ? (uint16_t)lroundf(s.humid * 10) : 0;
+  memcpy(out, &b, sizeof(b));
+  return sizeof(b);
+}
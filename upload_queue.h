@@ -0,0 +1,271 @@
+#pragma once
+/*
+ * Envio à nuvem com store-and-forward (RNF-01).
+ *
+ * A fila é o próprio histórico (history_log.h): os registros já estão na
+ * RAM e na flash, numerados em sequência contínua. O envio só guarda o
+ * cursor "confirmado até" (acked) na NVS e manda o trecho [acked, endSeq)
+ * em lotes:
+ *   - um POST a cada BATCH_RECS registros ou BATCH_MS, o que vier antes
+ *     (no lugar de um por amostra). Só vai o que já está na flash; se o prazo
+ *     vence com registros só na RAM, o histórico grava antes (dentro do
+ *     orçamento de gravações dele). Um registro enviado nunca some num reboot;
+ *   - corpo binário com delta + varint por campo (~12 B por registro contra
+ *     24 B do registro e ~250 B do JSON do /data);
+ *   - 2xx confirma o lote inteiro. Falha ou timeout: backoff exponencial
+ *     (BACKOFF_MIN_MS dobrando até BACKOFF_MAX_MS, com jitter) e o mesmo
+ *     trecho é reenviado. O servidor descarta seq repetido, então resposta
+ *     perdida não duplica nada;
+ *   - depois de uma queda longa a fila esvazia em lotes de até MAX_RECS
+ *     seguidos. Se o anel do histórico der a volta antes, o que foi
+ *     sobrescrito entra em lost().
+ *
+ * Formato do lote (application/x-irrig-batch, little-endian):
+ *   BatchHeader (12 B) + count x [varint(seq - seq anterior),
+ *   12 x varint(zigzag(campo - campo anterior))], campos na ordem de
+ *   batchFields(). O 1º registro usa seq = firstSeq e campos anteriores = 0.
+ *
+ * Link precisa de (no ESP32 é HTTPClient numa task; no host, sim/test_upload):
+ *   bool start(const uint8_t* body, size_t n, uint32_t nowMs);  // false = ocupado
+ *   int  poll(uint32_t nowMs);      // 0 = em andamento; >0 status HTTP; <0 erro
+ *   bool idle();                    // não lê mais o body (mesmo após o TIMEOUT_MS)
+ * O body aponta para o buffer da fila: depois de um timeout o lote só é
+ * remontado quando o link larga o POST anterior.
+ * Sem dependências do Arduino.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "history_log.h"
+
+namespace upload {
+
+const char BATCH_MIME[]    = "application/x-irrig-batch";
+const uint32_t BATCH_MAGIC = 0x31425249;   // "IRB1"
+const uint8_t  BATCH_VERSION = 1;
+const uint8_t  NFIELDS = 12;
+
+#pragma pack(push, 1)
+struct BatchHeader {
+  uint32_t magic;
+  uint8_t  version, count;
+  uint16_t _rsv;
+  uint32_t firstSeq;
+};
+#pragma pack(pop)
+static_assert(sizeof(BatchHeader) == 12, "BatchHeader deve ter 12 bytes");
+
+// Pior caso de um registro: varint de 32 bits (5 B) no seq e nos 12 campos
+const size_t MAX_REC_BYTES = 5 * (1 + NFIELDS);
+
+inline void batchFields(const HistRecord &r, int32_t f[NFIELDS]){
+  f[0] = (int32_t)r.ts;  f[1] = r.soilRaw;  f[2] = r.ldrRaw;  f[3] = r.waterRaw;
+  f[4] = r.temp_dC;      f[5] = r.humid_dPct;  f[6] = r.pumpMsSug;
+  f[7] = r.soilPct;      f[8] = r.ldrPct;  f[9] = r.waterPct;  f[10] = r.flags;  f[11] = r.ruleId;
+}
+inline void batchRecord(const int32_t f[NFIELDS], HistRecord &r){
+  r = HistRecord();
+  r.ts = (uint32_t)f[0];  r.soilRaw = f[1];  r.ldrRaw = f[2];  r.waterRaw = f[3];
+  r.temp_dC = f[4];       r.humid_dPct = f[5];  r.pumpMsSug = f[6];
+  r.soilPct = f[7];       r.ldrPct = f[8];  r.waterPct = f[9];  r.flags = f[10];  r.ruleId = f[11];
+}
+
+// Monta um lote em buf; add() recusa quando o próximo registro pode não caber
+class BatchWriter {
+public:
+  BatchWriter(uint8_t *buf, size_t cap) : buf_(buf), cap_(cap), len_(sizeof(BatchHeader)) {}
+
+  bool add(uint32_t seq, const HistRecord &r){
+    if (n_ == 255 || len_ + MAX_REC_BYTES > cap_) return false;
+    if (!n_){ first_ = prevSeq_ = seq; }
+    int32_t f[NFIELDS];
+    batchFields(r, f);
+    put(seq - prevSeq_);
+    for (uint8_t i = 0; i < NFIELDS; i++){
+      int32_t d = (int32_t)((uint32_t)f[i] - (uint32_t)prev_[i]);
+      put(((uint32_t)d << 1) ^ (uint32_t)(d >> 31));
+      prev_[i] = f[i];
+    }
+    prevSeq_ = seq;
+    n_++;
+    return true;
+  }
+
+  // Escreve o cabeçalho; retorna o tamanho do corpo
+  size_t finish(){
+    BatchHeader h = { BATCH_MAGIC, BATCH_VERSION, n_, 0, first_ };
+    memcpy(buf_, &h, sizeof(h));
+    return len_;
+  }
+  uint8_t count() const { return n_; }
+
+private:
+  void put(uint32_t v){
+    while (v >= 0x80){ buf_[len_++] = (uint8_t)(v | 0x80); v >>= 7; }
+    buf_[len_++] = (uint8_t)v;
+  }
+
+  uint8_t *buf_;
+  size_t   cap_, len_;
+  uint8_t  n_ = 0;
+  uint32_t first_ = 0, prevSeq_ = 0;
+  int32_t  prev_[NFIELDS] = {};
+};
+
+// Lado do servidor (e dos testes): fn(seq, const HistRecord&) por registro.
+// false se o corpo não é um lote v1 bem formado.
+template <class Fn>
+bool decodeBatch(const uint8_t *p, size_t n, Fn fn){
+  BatchHeader h;
+  if (n < sizeof(h)) return false;
+  memcpy(&h, p, sizeof(h));
+  if (h.magic != BATCH_MAGIC || h.version != BATCH_VERSION) return false;
+  size_t off = sizeof(h);
+  auto get = [&](uint32_t &v){
+    v = 0;
+    for (int sh = 0; sh < 35; sh += 7){
+      if (off >= n) return false;
+      uint8_t b = p[off++];
+      v |= (uint32_t)(b & 0x7F) << sh;
+      if (!(b & 0x80)) return true;
+    }
+    return false;
+  };
+  uint32_t seq = h.firstSeq, v;
+  int32_t f[NFIELDS] = {};
+  for (uint8_t k = 0; k < h.count; k++){
+    if (!get(v)) return false;
+    seq += v;
+    for (uint8_t i = 0; i < NFIELDS; i++){
+      if (!get(v)) return false;
+      f[i] = (int32_t)((uint32_t)f[i] + (uint32_t)((int32_t)(v >> 1) ^ -(int32_t)(v & 1)));
+    }
+    HistRecord r;
+    batchRecord(f, r);
+    fn(seq, r);
+  }
+  return off == n;
+}
+
+template <class Log, class Link>
+class UploadQueue {
+public:
+  static const uint16_t BATCH_RECS     = 16;                // = FLUSH_RECS do histórico
+  static const uint32_t BATCH_MS       = 20UL * 60 * 1000;  // lote parcial no máximo a cada 20 min
+  static const uint8_t  MAX_RECS       = 48;                // por requisição (esvaziar após queda)
+  static const size_t   BUF_SIZE       = 768;
+  static const uint32_t TIMEOUT_MS     = 20000;
+  static const uint32_t BACKOFF_MIN_MS = 5000;
+  static const uint32_t BACKOFF_MAX_MS = 30UL * 60 * 1000;
+
+  UploadQueue(Log &log, Link &link) : log_(log), link_(link) {}
+
+  // Semente do jitter (ex.: MAC): aparelhos que caíram juntos não voltam juntos
+  void seed(uint32_t s){ rng_ = s | 1; }
+
+  // Uma volta, sem esperar a rede. online = STA conectada.
+  // true quando o cursor avançou (o chamador persiste com saveCursor()).
+  bool tick(uint32_t nowMs, uint32_t nowSec, bool online){
+    if (sending_){
+      int r = link_.poll(nowMs);
+      if (!r && nowMs - startMs_ < TIMEOUT_MS) return false;
+      sending_ = false;
+      if (r >= 200 && r < 300){
+        acked_ = inflightEnd_;
+        sent_ += inflightRecs_;
+        fails_ = 0;
+        sinceMs_ = nowMs;
+        return true;
+      }
+      failures_++;
+      if (fails_ < 255) fails_++;
+      uint32_t b = fails_ >= 20 ? BACKOFF_MAX_MS : BACKOFF_MIN_MS << (fails_ - 1);
+      if (b > BACKOFF_MAX_MS) b = BACKOFF_MAX_MS;
+      rng_ = rng_ * 1664525u + 1013904223u;
+      retryMs_ = nowMs + b + (rng_ >> 8) % (b / 4 + 1);     // até +25 %
+      return false;
+    }
+
+    bool moved = reconcile();
+    uint32_t backlog = this->backlog();
+    if (!backlog){ sinceMs_ = nowMs; return moved; }
+    if (!online) return moved;
+    if (fails_){
+      if ((int32_t)(nowMs - retryMs_) < 0) return moved;
+    } else if (backlog < BATCH_RECS && nowMs - sinceMs_ < BATCH_MS) return moved;
+
+    if (!link_.idle()) return moved;                          // POST vencido ainda lê buf_
+    if (log_.endSeq() - acked_ < BATCH_RECS && log_.pending()) log_.flush(nowSec);
+    if (log_.endSeq() == acked_) return moved;
+
+    BatchWriter w(buf_, sizeof(buf_));
+    bool full = false;
+    uint32_t stop = 0;
+    uint32_t next = log_.readSeq(acked_, MAX_RECS, [&](uint32_t seq, const HistRecord &r){
+      if (!full && !w.add(seq, r)){ full = true; stop = seq; }
+    });
+    inflightEnd_ = full ? stop : next;
+    if (!w.count()){ acked_ = inflightEnd_; return true; }   // só registros inválidos
+    inflightRecs_ = w.count();
+    len_ = w.finish();
+    if (!link_.start(buf_, len_, nowMs)) return moved;        // recusou: tenta na próxima volta
+    sending_ = true;
+    startMs_ = nowMs;
+    requests_++;
+    bytes_ += len_;
+    return moved;
+  }
+
+  /* ---------- cursor na NVS (Preferences ou o mock do sim/) ---------- */
+  template <class Prefs>
+  void saveCursor(Prefs &prefs, const char *ns){
+    prefs.begin(ns, false);
+    prefs.putBytes("up_ack", &acked_, sizeof(acked_));
+    prefs.end();
+  }
+  template <class Prefs>
+  bool loadCursor(Prefs &prefs, const char *ns){
+    uint32_t v;
+    prefs.begin(ns, true);
+    bool ok = prefs.getBytes("up_ack", &v, sizeof(v)) == sizeof(v);
+    prefs.end();
+    if (ok) acked_ = v;
+    return ok;
+  }
+
+  uint32_t acked()    const { return acked_; }
+  uint32_t backlog()  const { return log_.endSeq() + log_.pending() - acked_; }
+  bool     sending()  const { return sending_; }
+  uint8_t  failStreak() const { return fails_; }
+  uint32_t requests() const { return requests_; }
+  uint32_t failures() const { return failures_; }
+  uint32_t sent()     const { return sent_; }
+  uint32_t bytes()    const { return bytes_; }
+  uint32_t lost()     const { return lost_; }
+
+private:
+  // Cursor fora do anel: à frente (arquivo do histórico recriado) volta ao
+  // início; atrás (anel deu a volta) pula para o mais antigo e conta a perda.
+  bool reconcile(){
+    uint32_t first = log_.firstSeq(), end = log_.endSeq();
+    if (acked_ > end){ acked_ = first; return true; }
+    if (acked_ < first){ lost_ += first - acked_; acked_ = first; return true; }
+    return false;
+  }
+
+  Log     &log_;
+  Link    &link_;
+  uint8_t  buf_[BUF_SIZE];
+  size_t   len_ = 0;
+
+  uint32_t acked_ = 0, inflightEnd_ = 0;
+  uint8_t  inflightRecs_ = 0;
+  bool     sending_ = false;
+  uint32_t startMs_ = 0, sinceMs_ = 0, retryMs_ = 0;
+  uint8_t  fails_ = 0;
+  uint32_t rng_ = 1;
+
+  uint32_t requests_ = 0, failures_ = 0, sent_ = 0, bytes_ = 0, lost_ = 0;
+};
+
+}  // namespace upload